@@ -0,0 +1,64 @@
+// agents -- many walkers in one maze
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef AGENTS_H
+#define AGENTS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "maze.h"
+#include "solve.h"
+
+// How an agent decides where to go: by following the wall, by going downhill
+// in the distances from the exit or at random.
+enum class POLICY { FOLLOWER, DISTANCE, RANDOM };
+
+constexpr int POLICIES = 3;
+
+const char* name(POLICY);
+bool find(const std::string&, POLICY&);
+
+// Any number of agents walking through the same maze to the same exit.  Each
+// agent's position and heading are kept in separate arrays (rather than an
+// array of structs) with all the agents using each policy next to each other
+// so that moving them is a simple loop over each policy's part of the
+// arrays.  Agents which reach the exit stay there.
+class Agents {
+public:
+    Agents();
+    Agents(const Maze&, const Position&,
+        const std::array<std::size_t, POLICIES>&, std::mt19937&);
+
+    std::size_t size() const;
+    std::size_t first(POLICY) const;
+    std::size_t last(POLICY) const;
+    std::size_t arrived() const;
+    bool vectorize(bool);
+    std::size_t step(const Maze&, std::mt19937&);
+
+    std::vector<std::int32_t> rows_;
+    std::vector<std::int32_t> cols_;
+    std::vector<std::uint8_t> headings_;
+
+private:
+    std::size_t follow(const Maze&, std::size_t, std::size_t);
+    std::size_t followSIMD(const Maze&, std::size_t, std::size_t);
+    std::size_t descend(const Maze&, std::size_t, std::size_t);
+    std::size_t wander(const Maze&, std::size_t, std::size_t,
+        std::mt19937&);
+
+    Position exit_;
+    std::array<std::size_t, POLICIES + 1> first_;
+    std::size_t arrived_;
+    Distances distances_;
+    bool simd_;
+};
+
+#endif
@@ -0,0 +1,14 @@
+// batch -- generate many mazes at once
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "generate.h"
+
+bool batch(unsigned, unsigned long, int, int, GENERATOR, unsigned, int);
+
+#endif
@@ -0,0 +1,15 @@
+// bench -- benchmarks
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+
+std::string benchmarks();
+bool benchmark(const std::string&, unsigned, int, int, unsigned);
+
+#endif
@@ -0,0 +1,38 @@
+// generate -- maze generation algorithms
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <functional>
+#include <random>
+#include <string>
+#include "maze.h"
+
+enum class GENERATOR { CARVER, BACKTRACKER, ELLER, KRUSKAL, WILSON, TILED };
+
+// Receives the rows of a maze, numbered from 0, as they are generated.  The
+// row is only valid for the duration of the call.
+using RowSink = std::function<void(int, const Maze::Word*)>;
+
+constexpr int GENERATORS = 6;
+
+const char* name(GENERATOR);
+bool find(const std::string&, GENERATOR&);
+void generate(GENERATOR, Maze&, std::mt19937&, unsigned = 0);
+Position chooseEntrance(const Maze&, std::mt19937&);
+Position chooseExit(const Maze&, std::mt19937&);
+
+void carve(Maze&, std::mt19937&);
+void backtrack(Maze&, std::mt19937&);
+void eller(Maze&, std::mt19937&);
+void eller(int, int, std::mt19937&, const RowSink&);
+void kruskal(Maze&, std::mt19937&);
+void wilson(Maze&, std::mt19937&);
+void tiled(Maze&, std::mt19937&);
+void tiled(Maze&, std::mt19937&, unsigned);
+
+#endif
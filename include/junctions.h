@@ -0,0 +1,54 @@
+// junctions -- a maze as a graph of its junctions
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef JUNCTIONS_H
+#define JUNCTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze.h"
+
+// Most cells of a maze are in corridors with exactly two ways out.  This is
+// a graph of the other cells (dead ends and junctions) plus the entrance and
+// exit with an edge for each corridor between them weighted by its length.
+// It is stored in compressed sparse row form: the edges leaving node n are
+// numbered from offsets_[n] up to offsets_[n + 1].  Nodes are numbered in the
+// order of their cells, row by row.
+class Junctions {
+public:
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+    Junctions();
+
+    void build(const Maze&, const Position&, const Position&);
+    std::size_t nodes() const;
+    std::size_t edges() const;
+    std::uint32_t node(const Position&) const;
+    Position position(std::uint32_t) const;
+
+    std::uint32_t dijkstra(std::uint32_t, std::uint32_t,
+        std::vector<std::uint32_t>&, std::size_t&) const;
+    std::uint32_t tremaux(std::uint32_t, std::uint32_t,
+        std::vector<std::uint32_t>&, std::size_t&) const;
+    void allPairs(std::vector<std::uint32_t>&) const;
+    void expand(const Maze&, std::uint32_t, const std::vector<std::uint32_t>&,
+        std::vector<Position>&) const;
+
+private:
+    bool isNode(const Maze&, int, int) const;
+
+    std::size_t width_;
+    Position entrance_;
+    Position exit_;
+    std::vector<std::size_t> cells_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> targets_;
+    std::vector<std::uint32_t> weights_;
+    std::vector<std::uint8_t> directions_;
+};
+
+#endif
@@ -0,0 +1,138 @@
+// maze -- maze grid
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef MAZE_H
+#define MAZE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class GO { EAST, SOUTH, WEST, NORTH };
+
+struct Position {
+    int row_;
+    int col_;
+};
+
+// The bit representing a direction in the mask returned by Maze::exits().
+constexpr unsigned bit(GO direction) {
+    return 1u << static_cast<unsigned>(direction);
+}
+
+// A grid of cells which are either open (true) or wall (false.)  The
+// dimensions are chosen at runtime.  Cells are packed 64 to a word with
+// column c of a row in bit c % 64 of word c / 64.  Each row starts on a new
+// word and any bits past the end of a row are always 0.
+//
+// Normally a Maze owns its cells but it can also be a view of cells stored
+// elsewhere, such as a file mapped into memory.  Copying either kind makes a
+// Maze which owns a copy of the cells.
+class Maze {
+public:
+    using Word = std::uint64_t;
+    static constexpr int BITS = 64;
+
+    Maze(int height, int width);
+    Maze(int height, int width, Word* cells);
+    Maze(const Maze&);
+    Maze(Maze&&) noexcept;
+    Maze& operator=(const Maze&);
+    Maze& operator=(Maze&&) noexcept;
+    ~Maze() = default;
+
+    void clear();
+    bool at(int row, int col) const;
+    void set(int row, int col, bool open = true);
+    unsigned exits(int row, int col) const;
+    Word open(int row, int word, GO direction) const;
+    int count(int row, int first, int last) const;
+    int nth(int row, int first, int last, int n) const;
+
+    int height() const;
+    int width() const;
+    int stride() const;
+    const Word* row(int row) const;
+    Word* row(int row);
+    std::size_t bytes() const;
+
+private:
+    Word mask(int first, int last, int word) const;
+
+    int height_;
+    int width_;
+    int stride_;
+    std::vector<Word> words_;
+    Word* cells_;
+};
+
+inline void Maze::clear() {
+    std::fill(cells_, cells_ + bytes() / sizeof(Word), 0);
+}
+
+inline bool Maze::at(int row, int col) const {
+    return (cells_[static_cast<std::size_t>(row) * stride_ + col / BITS] >>
+        (col % BITS)) & 1;
+}
+
+inline void Maze::set(int row, int col, bool open) {
+    auto& word = cells_[static_cast<std::size_t>(row) * stride_ + col / BITS];
+    auto bit = Word{1} << (col % BITS);
+
+    if (open) {
+        word |= bit;
+    } else {
+        word &= ~bit;
+    }
+}
+
+// Which of the four cells around (row, col) are open, as a mask of bit(GO)s.
+// Cells beyond the edges of the maze count as walls.
+inline unsigned Maze::exits(int row, int col) const {
+    unsigned result = 0;
+
+    if (col + 1 < width_ && at(row, col + 1)) {
+        result |= bit(GO::EAST);
+    }
+    if (row + 1 < height_ && at(row + 1, col)) {
+        result |= bit(GO::SOUTH);
+    }
+    if (col > 0 && at(row, col - 1)) {
+        result |= bit(GO::WEST);
+    }
+    if (row > 0 && at(row - 1, col)) {
+        result |= bit(GO::NORTH);
+    }
+
+    return result;
+}
+
+inline int Maze::height() const {
+    return height_;
+}
+
+inline int Maze::width() const {
+    return width_;
+}
+
+inline int Maze::stride() const {
+    return stride_;
+}
+
+inline const Maze::Word* Maze::row(int row) const {
+    return cells_ + static_cast<std::size_t>(row) * stride_;
+}
+
+inline Maze::Word* Maze::row(int row) {
+    return cells_ + static_cast<std::size_t>(row) * stride_;
+}
+
+inline std::size_t Maze::bytes() const {
+    return static_cast<std::size_t>(height_) * stride_ * sizeof(Word);
+}
+
+#endif
@@ -0,0 +1,66 @@
+// mazefile -- save and load mazes
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef MAZEFILE_H
+#define MAZEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include "generate.h"
+#include "maze.h"
+
+// A maze is saved as this header followed by bytes_ bytes of cells packed
+// exactly as they are in Maze.  Numbers are in the byte order of the machine
+// which wrote them.  A file can hold any number of mazes one after another.
+struct MazeHeader {
+    char magic_[8];
+    std::uint32_t version_;
+    std::uint32_t generator_;
+    std::uint32_t seed_;
+    std::int32_t height_;
+    std::int32_t width_;
+    std::int32_t entranceRow_;
+    std::int32_t entranceCol_;
+    std::int32_t exitRow_;
+    std::int32_t exitCol_;
+    std::uint32_t unused_;
+    std::uint64_t bytes_;
+    std::uint64_t reserved_;
+};
+
+static_assert(sizeof(MazeHeader) == 64, "MazeHeader must be 64 bytes");
+
+MazeHeader makeHeader(const Maze&, unsigned, GENERATOR, const Position&,
+    const Position&);
+bool save(int, off_t, const MazeHeader&, const Maze&);
+char* serialize(char*, const MazeHeader&, const Maze&);
+bool writeAt(int, off_t, const void*, std::size_t);
+
+// A file of mazes mapped into memory.  The cells of a maze in the file can be
+// used directly without reading them into memory first.  Changes to them are
+// not written back to the file.
+class MazeFile {
+public:
+    MazeFile();
+    MazeFile(const MazeFile&) = delete;
+    MazeFile& operator=(const MazeFile&) = delete;
+    ~MazeFile();
+
+    bool open(const std::string&, unsigned long);
+    const MazeHeader& header() const;
+    Maze maze() const;
+
+private:
+    void close();
+
+    void* map_;
+    std::size_t size_;
+    MazeHeader* header_;
+};
+
+#endif
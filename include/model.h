@@ -0,0 +1,51 @@
+// model -- maze demo state
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <cstddef>
+#include <random>
+#include "agents.h"
+#include "generate.h"
+#include "maze.h"
+#include "solve.h"
+
+class Model {
+public:
+    Model(unsigned, int, int, GENERATOR = GENERATOR::CARVER, unsigned = 0);
+    Model(unsigned, GENERATOR, Maze, const Position&, const Position&);
+
+    std::size_t fillDeadEnds(Workspace&);
+    bool solve(SOLVER, Workspace&);
+    bool finished() const;
+    std::size_t run();
+    std::size_t run(std::size_t&);
+    void update();
+
+    unsigned seed_;
+    GENERATOR generator_;
+    std::mt19937 rnd_;
+    Maze maze_;
+    Position entrance_;
+    Position exit_;
+    Position player_;
+    float tick_;
+    GO direction_;
+    SOLVER solver_;
+    Solution solution_;
+    std::size_t step_;
+    Agents agents_;
+
+private:
+
+    void follow();
+    Maze makeMaze(int, int, unsigned);
+    Position makeEntrance();
+    Position makeExit();
+};
+
+#endif
@@ -709,6 +709,10 @@ namespace olc
 		olc::vf2d vScale = { 1, 1 };
 		bool bShow = false;
 		bool bUpdate = false;
+		// Set by UpdateLayerRows() when only some rows need to be uploaded
+		bool bPartial = false;
+		int32_t nUpdateTop = 0;
+		int32_t nUpdateBottom = 0;
 		olc::Sprite* pDrawTarget = nullptr;
 		uint32_t nResID = 0;
 		std::vector<DecalInstance> vecDecalInstance;
@@ -730,6 +734,7 @@ namespace olc
 		virtual void       DrawDecalQuad(const olc::DecalInstance& decal) = 0;
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
+		virtual void       UpdateTextureRows(uint32_t id, olc::Sprite* spr, int32_t top, int32_t bottom) { (void)top; (void)bottom; UpdateTexture(id, spr); }
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
@@ -837,6 +842,9 @@ namespace olc
 		void SetLayerScale(uint8_t layer, float x, float y);
 		void SetLayerTint(uint8_t layer, const olc::Pixel& tint);
 		void SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f);
+		// Only rows top to bottom - 1 of the layer have changed this frame so
+		// only they need to be uploaded.  Can be called more than once.
+		void UpdateLayerRows(uint8_t layer, int32_t top, int32_t bottom);
 
 		std::vector<LayerDesc>& GetLayers();
 		uint32_t CreateLayer();
@@ -934,6 +942,15 @@ namespace olc
 		std::string sAppName;
 
 	private: // Inner mysterious workings
+		// Copies an opaque, unflipped sprite a row at a time
+		void CopySprite(int32_t x, int32_t y, Sprite* sprite, uint32_t scale);
+		// Blends a translucent, unflipped sprite a row at a time
+		void BlendSprite(int32_t x, int32_t y, Sprite* sprite);
+		// Draws pixels sx to ex inclusive of row y in the current pixel mode
+		void DrawSpan(int32_t sx, int32_t ex, int32_t y, Pixel p);
+		// The blend factor as a number from 0 to 255
+		uint32_t BlendFactor() const;
+
 		Sprite*		pDrawTarget = nullptr;
 		Pixel::Mode	nPixelMode = Pixel::NORMAL;
 		float		fBlendFactor = 1.0f;
@@ -1055,12 +1072,200 @@ namespace olc
 #ifdef OLC_PGE_APPLICATION
 #undef OLC_PGE_APPLICATION
 
+#if defined(__x86_64__) || defined(__i386__)
+	#define OLC_SPAN_SIMD
+	#include <immintrin.h>
+#endif
+
+// Fills bigger than this many bytes bypass the cache with non-temporal stores
+#if !defined(OLC_FILL_STREAM_BYTES)
+	#define OLC_FILL_STREAM_BYTES (8 * 1024 * 1024)
+#endif
+
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine INTERFACE IMPLEMENTATION (CORE)                           |
 // | Note: The core implementation is platform independent                        |
 // O------------------------------------------------------------------------------O
 namespace olc
 {
+	// O------------------------------------------------------------------------------O
+	// | Span kernels - operate on runs of pixels in one row of a sprite              |
+	// O------------------------------------------------------------------------------O
+	namespace span
+	{
+#if defined(OLC_SPAN_SIMD)
+		__attribute__((target("avx2")))
+		static void FillAVX2(Pixel* p, size_t n, uint32_t c, bool stream)
+		{
+			for (; n > 0 && (reinterpret_cast<uintptr_t>(p) & 31); n--) (p++)->n = c;
+
+			__m256i v = _mm256_set1_epi32(int32_t(c));
+			__m256i* q = reinterpret_cast<__m256i*>(p);
+			size_t blocks = n / 8;
+			if (stream)
+			{
+				for (size_t i = 0; i < blocks; i++) _mm256_stream_si256(q + i, v);
+				_mm_sfence();
+			}
+			else
+			{
+				for (size_t i = 0; i < blocks; i++) _mm256_store_si256(q + i, v);
+			}
+
+			p += blocks * 8;
+			for (n -= blocks * 8; n > 0; n--) (p++)->n = c;
+		}
+
+		__attribute__((target("sse2")))
+		static void FillSSE2(Pixel* p, size_t n, uint32_t c, bool stream)
+		{
+			for (; n > 0 && (reinterpret_cast<uintptr_t>(p) & 15); n--) (p++)->n = c;
+
+			__m128i v = _mm_set1_epi32(int32_t(c));
+			__m128i* q = reinterpret_cast<__m128i*>(p);
+			size_t blocks = n / 4;
+			if (stream)
+			{
+				for (size_t i = 0; i < blocks; i++) _mm_stream_si128(q + i, v);
+				_mm_sfence();
+			}
+			else
+			{
+				for (size_t i = 0; i < blocks; i++) _mm_store_si128(q + i, v);
+			}
+
+			p += blocks * 4;
+			for (n -= blocks * 4; n > 0; n--) (p++)->n = c;
+		}
+#endif
+
+		// Alpha blending is done in fixed point.  The alpha of the source
+		// pixel is scaled by the blend factor (0 - 255) and then each channel
+		// is s * a + d * (255 - a), divided by 255 with rounding.  The result
+		// is always opaque.
+		static inline uint32_t Div255(uint32_t x)
+		{
+			x += 128;
+			return (x + (x >> 8)) >> 8;
+		}
+
+		static inline Pixel BlendPixel(Pixel s, Pixel d, uint32_t blend)
+		{
+			uint32_t a = Div255(s.a * blend);
+			uint32_t c = 255 - a;
+			return Pixel(uint8_t(Div255(s.r * a + d.r * c)), uint8_t(Div255(s.g * a + d.g * c)), uint8_t(Div255(s.b * a + d.b * c)));
+		}
+
+#if defined(OLC_SPAN_SIMD)
+		// The same on 16 bit channels, two pixels per 128 bits
+		__attribute__((target("sse2")))
+		static inline __m128i Div255SSE2(__m128i x)
+		{
+			x = _mm_add_epi16(x, _mm_set1_epi16(128));
+			return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+		}
+
+		__attribute__((target("sse2")))
+		static inline __m128i BlendSSE2(__m128i s, __m128i d, __m128i blend)
+		{
+			__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			a = Div255SSE2(_mm_mullo_epi16(a, blend));
+			__m128i c = _mm_sub_epi16(_mm_set1_epi16(255), a);
+			return Div255SSE2(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, c)));
+		}
+
+		__attribute__((target("sse2")))
+		static void BlendSSE2(Pixel* d, const Pixel* s, size_t n, uint32_t blend)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i opaque = _mm_set1_epi32(int32_t(0xFF000000));
+			const __m128i b = _mm_set1_epi16(int16_t(blend));
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+			{
+				__m128i sp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+				__m128i dp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+				__m128i lo = BlendSSE2(_mm_unpacklo_epi8(sp, zero), _mm_unpacklo_epi8(dp, zero), b);
+				__m128i hi = BlendSSE2(_mm_unpackhi_epi8(sp, zero), _mm_unpackhi_epi8(dp, zero), b);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+			}
+			for (; i < n; i++) d[i] = BlendPixel(s[i], d[i], blend);
+		}
+
+		__attribute__((target("avx2")))
+		static inline __m256i Div255AVX2(__m256i x)
+		{
+			x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+			return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+		}
+
+		__attribute__((target("avx2")))
+		static inline __m256i BlendAVX2(__m256i s, __m256i d, __m256i blend)
+		{
+			__m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			a = Div255AVX2(_mm256_mullo_epi16(a, blend));
+			__m256i c = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+			return Div255AVX2(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, c)));
+		}
+
+		__attribute__((target("avx2")))
+		static void BlendAVX2(Pixel* d, const Pixel* s, size_t n, uint32_t blend)
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i opaque = _mm256_set1_epi32(int32_t(0xFF000000));
+			const __m256i b = _mm256_set1_epi16(int16_t(blend));
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+			{
+				__m256i sp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+				__m256i dp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+				__m256i lo = BlendAVX2(_mm256_unpacklo_epi8(sp, zero), _mm256_unpacklo_epi8(dp, zero), b);
+				__m256i hi = BlendAVX2(_mm256_unpackhi_epi8(sp, zero), _mm256_unpackhi_epi8(dp, zero), b);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_or_si256(_mm256_packus_epi16(lo, hi), opaque));
+			}
+			for (; i < n; i++) d[i] = BlendPixel(s[i], d[i], blend);
+		}
+
+		static bool HasAVX2()
+		{
+			static const bool bAVX2 = __builtin_cpu_supports("avx2");
+			return bAVX2;
+		}
+#endif
+
+		// Sets n pixels starting at p to c.  If stream is true the pixels are
+		// written straight to memory without displacing what is in the cache.
+		static void Fill(Pixel* p, size_t n, Pixel c, bool stream)
+		{
+#if defined(OLC_SPAN_SIMD)
+			if (HasAVX2()) FillAVX2(p, n, c.n, stream);
+			else FillSSE2(p, n, c.n, stream);
+#else
+			(void)stream;
+			std::fill(p, p + n, c);
+#endif
+		}
+
+		// Blends n pixels from s into the n pixels starting at d.
+		static void Blend(Pixel* d, const Pixel* s, size_t n, uint32_t blend)
+		{
+#if defined(OLC_SPAN_SIMD)
+			if (HasAVX2()) BlendAVX2(d, s, n, blend);
+			else BlendSSE2(d, s, n, blend);
+#else
+			for (size_t i = 0; i < n; i++) d[i] = BlendPixel(s[i], d[i], blend);
+#endif
+		}
+
+		// Blends c into the n pixels starting at d, a few at a time.
+		static void BlendFill(Pixel* d, size_t n, Pixel c, uint32_t blend)
+		{
+			Pixel s[64];
+			std::fill(s, s + 64, c);
+			for (size_t i = 0; i < n; i += 64) Blend(d + i, s, std::min(n - i, size_t(64)), blend);
+		}
+	}
+
 	// O------------------------------------------------------------------------------O
 	// | olc::Pixel IMPLEMENTATION                                                    |
 	// O------------------------------------------------------------------------------O
@@ -1711,6 +1916,27 @@ namespace olc
 		if (layer < vLayers.size()) vLayers[layer].funcHook = f;
 	}
 
+	void PixelGameEngine::UpdateLayerRows(uint8_t layer, int32_t top, int32_t bottom)
+	{
+		if (layer >= vLayers.size()) return;
+		LayerDesc& ld = vLayers[layer];
+		top = std::max(top, 0);
+		bottom = std::min(bottom, ld.pDrawTarget->height);
+		if (top >= bottom)
+		{
+			ld.bPartial = true;
+			return;
+		}
+		if (ld.bPartial && ld.nUpdateTop < ld.nUpdateBottom)
+		{
+			top = std::min(top, ld.nUpdateTop);
+			bottom = std::max(bottom, ld.nUpdateBottom);
+		}
+		ld.bPartial = true;
+		ld.nUpdateTop = top;
+		ld.nUpdateBottom = bottom;
+	}
+
 	std::vector<LayerDesc>& PixelGameEngine::GetLayers()
 	{ return vLayers; }
 
@@ -1813,12 +2039,7 @@ namespace olc
 		if (nPixelMode == Pixel::ALPHA)
 		{
 			Pixel d = pDrawTarget->GetPixel(x, y);
-			float a = (float)(p.a / 255.0f) * fBlendFactor;
-			float c = 1.0f - a;
-			float r = a * (float)p.r + c * (float)d.r;
-			float g = a * (float)p.g + c * (float)d.g;
-			float b = a * (float)p.b + c * (float)d.b;
-			return pDrawTarget->SetPixel(x, y, Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/));
+			return pDrawTarget->SetPixel(x, y, span::BlendPixel(p, d, BlendFactor()));
 		}
 
 		if (nPixelMode == Pixel::CUSTOM)
@@ -1973,8 +2194,7 @@ namespace olc
 
 			auto drawline = [&](int sx, int ex, int y)
 			{
-				for (int x = sx; x <= ex; x++)
-					Draw(x, y, p);
+				DrawSpan(sx, ex, y, p);
 			};
 
 			while (y0 >= x0)
@@ -2014,9 +2234,8 @@ namespace olc
 
 	void PixelGameEngine::Clear(Pixel p)
 	{
-		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
-		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		size_t pixels = size_t(GetDrawTargetWidth()) * GetDrawTargetHeight();
+		span::Fill(GetDrawTarget()->GetData(), pixels, p, pixels * sizeof(Pixel) > OLC_FILL_STREAM_BYTES);
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -2044,6 +2263,24 @@ namespace olc
 		if (y2 < 0) y2 = 0;
 		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
 
+		if (nPixelMode == Pixel::NORMAL && pDrawTarget)
+		{
+			if (x >= x2) return;
+			size_t w = size_t(x2 - x);
+			bool stream = w * size_t(std::max(y2 - y, 0)) * sizeof(Pixel) > OLC_FILL_STREAM_BYTES;
+			for (int j = y; j < y2; j++)
+				span::Fill(pDrawTarget->GetData() + size_t(j) * pDrawTarget->width + x, w, p, stream);
+			return;
+		}
+
+		if (nPixelMode == Pixel::ALPHA && pDrawTarget)
+		{
+			if (x >= x2) return;
+			for (int j = y; j < y2; j++)
+				span::BlendFill(pDrawTarget->GetData() + size_t(j) * pDrawTarget->width + x, size_t(x2 - x), p, BlendFactor());
+			return;
+		}
+
 		for (int i = x; i < x2; i++)
 			for (int j = y; j < y2; j++)
 				Draw(i, j, p);
@@ -2069,7 +2306,7 @@ namespace olc
 	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+		auto drawline = [&](int sx, int ex, int ny) { DrawSpan(sx, ex, ny, p); };
 
 		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
 		bool changed1 = false;
@@ -2213,6 +2450,20 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		// Opaque and unflipped sprites can be copied a row at a time
+		if (nPixelMode == Pixel::NORMAL && flip == olc::Sprite::Flip::NONE && pDrawTarget)
+		{
+			CopySprite(x, y, sprite, scale);
+			return;
+		}
+
+		// Translucent ones can be blended a row at a time
+		if (nPixelMode == Pixel::ALPHA && flip == olc::Sprite::Flip::NONE && scale <= 1 && pDrawTarget)
+		{
+			BlendSprite(x, y, sprite);
+			return;
+		}
+
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
@@ -2242,6 +2493,89 @@ namespace olc
 		}
 	}
 
+	void PixelGameEngine::CopySprite(int32_t x, int32_t y, Sprite* sprite, uint32_t scale)
+	{
+		if (scale < 1) scale = 1;
+		int32_t s = int32_t(scale);
+
+		// Clip the whole sprite against the draw target once
+		int32_t x1 = std::max(x, 0);
+		int32_t y1 = std::max(y, 0);
+		int32_t x2 = std::min(x + sprite->width * s, pDrawTarget->width);
+		int32_t y2 = std::min(y + sprite->height * s, pDrawTarget->height);
+		if (x1 >= x2 || y1 >= y2) return;
+
+		const Pixel* src = sprite->GetData();
+		Pixel* dst = pDrawTarget->GetData();
+		int32_t dw = pDrawTarget->width;
+		size_t bytes = size_t(x2 - x1) * sizeof(Pixel);
+
+		if (s == 1)
+		{
+			for (int32_t j = y1; j < y2; j++)
+				std::memcpy(dst + j * dw + x1, src + (j - y) * sprite->width + (x1 - x), bytes);
+			return;
+		}
+
+		// Widen each sprite row into the first screen row it covers and copy
+		// that to the rest
+		for (int32_t j = y1; j < y2;)
+		{
+			int32_t sy = (j - y) / s;
+			int32_t end = std::min(y + (sy + 1) * s, y2);
+			const Pixel* in = src + sy * sprite->width + (x1 - x) / s;
+			Pixel* out = dst + j * dw;
+			int32_t left = s - (x1 - x) % s;
+			for (int32_t i = x1; i < x2; i++)
+			{
+				out[i] = *in;
+				if (--left == 0) { in++; left = s; }
+			}
+			for (int32_t k = j + 1; k < end; k++)
+				std::memcpy(dst + k * dw + x1, out + x1, bytes);
+			j = end;
+		}
+	}
+
+	void PixelGameEngine::BlendSprite(int32_t x, int32_t y, Sprite* sprite)
+	{
+		int32_t x1 = std::max(x, 0);
+		int32_t y1 = std::max(y, 0);
+		int32_t x2 = std::min(x + sprite->width, pDrawTarget->width);
+		int32_t y2 = std::min(y + sprite->height, pDrawTarget->height);
+		if (x1 >= x2 || y1 >= y2) return;
+
+		uint32_t blend = BlendFactor();
+		for (int32_t j = y1; j < y2; j++)
+			span::Blend(pDrawTarget->GetData() + j * pDrawTarget->width + x1, sprite->GetData() + (j - y) * sprite->width + (x1 - x), size_t(x2 - x1), blend);
+	}
+
+	void PixelGameEngine::DrawSpan(int32_t sx, int32_t ex, int32_t y, Pixel p)
+	{
+		if (pDrawTarget && (nPixelMode == Pixel::NORMAL || nPixelMode == Pixel::ALPHA))
+		{
+			if (y < 0 || y >= pDrawTarget->height) return;
+			sx = std::max(sx, 0);
+			ex = std::min(ex, pDrawTarget->width - 1);
+			if (sx > ex) return;
+
+			Pixel* d = pDrawTarget->GetData() + y * pDrawTarget->width + sx;
+			if (nPixelMode == Pixel::NORMAL)
+				span::Fill(d, size_t(ex - sx + 1), p, false);
+			else
+				span::BlendFill(d, size_t(ex - sx + 1), p, BlendFactor());
+			return;
+		}
+
+		for (int32_t x = sx; x <= ex; x++)
+			Draw(x, y, p);
+	}
+
+	uint32_t PixelGameEngine::BlendFactor() const
+	{
+		return uint32_t(fBlendFactor * 255.0f + 0.5f);
+	}
+
 	void PixelGameEngine::DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale, uint8_t flip)
 	{
 		DrawPartialSprite(pos.x, pos.y, sprite, sourcepos.x, sourcepos.y, size.x, size.y, scale, flip);
@@ -2888,8 +3222,9 @@ namespace olc
 		renderer->UpdateViewport(vViewPos, vViewSize);
 		renderer->ClearBuffer(olc::BLACK, true);
 
-		// Layer 0 must always exist
-		vLayers[0].bUpdate = true;
+		// Layer 0 must always exist and is uploaded every frame unless the
+		// application has said which rows changed
+		if (!vLayers[0].bPartial) vLayers[0].bUpdate = true;
 		vLayers[0].bShow = true;
 		renderer->PrepareDrawing();
 
@@ -2905,6 +3240,12 @@ namespace olc
 						renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
 						layer->bUpdate = false;
 					}
+					else if (layer->bPartial && layer->nUpdateTop < layer->nUpdateBottom)
+					{
+						renderer->UpdateTextureRows(layer->nResID, layer->pDrawTarget, layer->nUpdateTop, layer->nUpdateBottom);
+					}
+					layer->bPartial = false;
+					layer->nUpdateTop = layer->nUpdateBottom = 0;
 
 					renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
 
@@ -3307,6 +3648,12 @@ namespace olc
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
+		void UpdateTextureRows(uint32_t id, olc::Sprite* spr, int32_t top, int32_t bottom) override
+		{
+			UNUSED(id);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top, spr->width, bottom - top, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData() + top * spr->width);
+		}
+
 		void ApplyTexture(uint32_t id) override
 		{
 			glBindTexture(GL_TEXTURE_2D, id);
@@ -0,0 +1,30 @@
+// pbm -- write mazes as portable bitmap images
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef PBM_H
+#define PBM_H
+
+#include <ostream>
+#include <vector>
+#include "maze.h"
+
+// Writes a maze in the binary ("P4") PBM format with walls as black pixels.
+// The rows can be given one at a time so the whole maze never has to be in
+// memory.
+class PBM {
+public:
+    PBM(std::ostream&, int, int);
+
+    void row(const Maze::Word*);
+    void write(const Maze&);
+
+private:
+    std::ostream& out_;
+    int width_;
+    std::vector<char> buffer_;
+};
+
+#endif
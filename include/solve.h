@@ -0,0 +1,237 @@
+// solve -- maze solving algorithms
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#ifndef SOLVE_H
+#define SOLVE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "junctions.h"
+#include "maze.h"
+
+// The wall follower is not solved here; it is Model::update() (and
+// Agents::step()) which use TURNS.
+enum class SOLVER { FOLLOWER, BFS, ASTAR, BIDIRECTIONAL, DISTANCE, JUNCTIONS,
+    TREMAUX, DIJKSTRA };
+
+constexpr int SOLVERS = 8;
+
+struct Turn {
+    GO direction_;
+    int jump_;
+};
+
+using Turns = std::array<std::array<Turn, 16>, 4>;
+
+// Which way the wall follower goes next for each direction it could be going
+// in and each mask of open neighbours returned by Maze::exits().  It turns
+// right if it can, otherwise goes straight on, otherwise turns left and if
+// there is no other choice goes back the way it came.  If it is boxed in on
+// all four sides it keeps going the same way.
+//
+// When going west and turning north, the follower has always taken an extra
+// step north straight away (jump_) and paths depend on that.
+constexpr Turns makeTurns() {
+    Turns turns{};
+
+    for (auto d = 0; d < 4; d++) {
+        const int order[] = { (d + 1) % 4, d, (d + 3) % 4, (d + 2) % 4 };
+
+        for (auto exits = 0u; exits < 16; exits++) {
+            auto& turn = turns[d][exits];
+            turn = Turn{ static_cast<GO>(d), 0 };
+
+            for (auto next : order) {
+                if (exits & (1u << next)) {
+                    turn.direction_ = static_cast<GO>(next);
+                    turn.jump_ = (d == static_cast<int>(GO::WEST) &&
+                        next == static_cast<int>(GO::NORTH)) ? 1 : 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    return turns;
+}
+
+inline constexpr Turns TURNS = makeTurns();
+
+// A queue of cell numbers kept in a circular buffer.  The buffer only grows
+// (doubling in size) if it is full so once it is big enough for a maze it
+// can be reused without allocating any more memory.
+class Frontier {
+public:
+    explicit Frontier(std::size_t = 1024);
+
+    void clear();
+    bool empty() const;
+    std::size_t size() const;
+    void push(std::size_t);
+    std::size_t pop();
+
+private:
+    void grow();
+
+    std::vector<std::size_t> cells_;
+    std::size_t mask_;
+    std::size_t head_;
+    std::size_t tail_;
+};
+
+// A direction for each cell in a maze packed into 2 bits.
+class Directions {
+public:
+    Directions();
+
+    void reset(std::size_t);
+    GO get(std::size_t) const;
+    void set(std::size_t, GO);
+    std::size_t bytes() const;
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+// A change to a maze: the cell at cell_ is made open (if open_ is true) or a
+// wall.
+struct Edit {
+    Position cell_;
+    bool open_;
+};
+
+// How many steps it is from each cell of a maze to the nearest of a set of
+// cells (usually just the exit.)  Distances are stored in 16 bits if the
+// maze is small enough for them all to fit, otherwise in 32 bits.
+class Distances {
+public:
+    static constexpr std::uint32_t UNREACHABLE = 0xFFFFFFFF;
+
+    Distances();
+
+    std::size_t build(const Maze&, const std::vector<Position>&, Frontier&);
+    std::size_t apply(Maze&, const std::vector<Edit>&, Frontier&);
+    std::uint32_t at(int row, int col) const;
+    bool next(const Maze&, const Position&, GO&) const;
+    std::size_t bytes() const;
+
+private:
+    static constexpr std::uint16_t FAR = 0xFFFF;
+    static constexpr std::size_t REBUILD = 64;
+
+    std::uint32_t get(std::size_t) const;
+    void set(std::size_t, std::uint32_t);
+    bool source(std::size_t) const;
+    std::uint32_t nearest(const Maze&, std::size_t) const;
+    std::size_t rebuild(const Maze&, Frontier&);
+
+    int width_;
+    std::vector<std::uint16_t> near_;
+    std::vector<std::uint32_t> far_;
+    std::vector<std::size_t> sources_;
+    std::vector<std::pair<std::size_t, std::uint32_t>> lost_;
+    std::vector<std::size_t> affected_;
+    std::vector<std::pair<std::uint32_t, std::size_t>> seeds_;
+    std::vector<std::pair<std::uint32_t, std::size_t>> queue_;
+};
+
+// A breadth-first search which moves a whole word (64 cells) of the frontier
+// at a time with shifts and ANDs.  It finds how far cells are from a
+// starting point but not the path to them.  Only words with some of the
+// frontier in them are looked at on each level so a narrow frontier costs no
+// more than a wide one.
+class Wavefront {
+public:
+    Wavefront();
+
+    std::uint32_t distance(const Maze&, const Position&, const Position&);
+    std::size_t flood(const Maze&, const Position&);
+    std::size_t levels() const;
+    const Maze& reached() const;
+
+private:
+    std::size_t spread(const Maze&, const Position&, const Position*);
+    void add(std::size_t, Maze::Word);
+
+    Maze reached_;
+    Maze current_;
+    Maze next_;
+    std::vector<std::size_t> active_;
+    std::vector<std::size_t> waiting_;
+    std::size_t levels_;
+};
+
+// Memory used by the solvers.  Keeping one of these from one solve to the
+// next saves having to allocate it again.
+struct Workspace {
+    Workspace();
+
+    void reset(const Maze&, bool backwards = false);
+
+    Frontier frontier_;
+    Maze seen_;
+    Directions parent_;
+    Frontier back_;
+    Maze seenBack_;
+    Directions parentBack_;
+    std::vector<std::size_t> now_;
+    std::vector<std::size_t> later_;
+    std::vector<std::pair<std::uint64_t, std::size_t>> open_;
+    std::vector<std::size_t> deadEnds_;
+    Distances distances_;
+    Junctions junctions_;
+    std::vector<std::uint32_t> edges_;
+};
+
+// How astar() guesses the number of steps left from a cell to the end.  The
+// guess must never be more than the real number of steps and must not go
+// down by more than 1 with each step.  If it always goes up or down by
+// exactly 1 (unit_ is true) astar() can use a simpler, faster queue.
+struct Heuristic {
+    std::uint32_t (*estimate_)(const Position&, const Position&);
+    bool unit_;
+};
+
+std::uint32_t manhattan(const Position&, const Position&);
+std::uint32_t zero(const Position&, const Position&);
+
+inline constexpr Heuristic MANHATTAN{manhattan, true};
+inline constexpr Heuristic ZERO{zero, false};
+
+struct Solution {
+    std::vector<Position> path_;
+    std::size_t expanded_;
+};
+
+const char* name(SOLVER);
+bool find(const std::string&, SOLVER&);
+bool solve(SOLVER, const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+
+std::size_t fillDeadEnds(Maze&, const Position&, const Position&, Workspace&);
+
+bool bfs(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool astar(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool astar(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&, const Heuristic&);
+bool dijkstra(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool bidirectional(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool descend(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool junctions(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+bool tremaux(const Maze&, const Position&, const Position&, Workspace&,
+    Solution&);
+
+#endif
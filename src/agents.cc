@@ -0,0 +1,343 @@
+// agents -- many walkers in one maze
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include "agents.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AGENTS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+    struct Policy {
+        POLICY policy_;
+        const char* name_;
+    };
+
+    const std::array<Policy, POLICIES> policies {
+        Policy{POLICY::FOLLOWER, "follower"},
+        Policy{POLICY::DISTANCE, "distance"},
+        Policy{POLICY::RANDOM, "random"}
+    };
+
+    // How far one step in each direction moves an agent.
+    constexpr std::int32_t ROWS[] = { 0, 1, 0, -1 };
+    constexpr std::int32_t COLS[] = { 1, 0, -1, 0 };
+
+#ifdef AGENTS_AVX2
+    using Headings = std::array<std::int32_t, 64>;
+
+    // The new heading from TURNS for each heading * 16 + mask of exits, as
+    // 32 bit numbers so they can be gathered.
+    constexpr Headings makeHeadings() {
+        Headings headings{};
+
+        for (auto i = 0; i < 64; i++) {
+            headings[i] =
+                static_cast<std::int32_t>(TURNS[i / 16][i % 16].direction_);
+        }
+
+        return headings;
+    }
+
+    constexpr Headings HEADINGS = makeHeadings();
+
+    // Whether each of the cells at rows and cols is open (1) or not (0).
+    // cells is the maze as 32 bit words, words of them per row.  Only cells
+    // where valid is set are looked at, the rest are treated as walls.
+    __attribute__((target("avx2")))
+    __m256i gather(const int* cells, __m256i words, __m256i rows, __m256i cols,
+    __m256i valid) {
+        auto index = _mm256_add_epi32(_mm256_mullo_epi32(rows, words),
+            _mm256_srli_epi32(cols, 5));
+        auto word = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), cells,
+            index, valid, 4);
+
+        return _mm256_and_si256(_mm256_srlv_epi32(word,
+            _mm256_and_si256(cols, _mm256_set1_epi32(31))),
+            _mm256_set1_epi32(1));
+    }
+#endif
+}
+
+const char* name(POLICY policy) {
+    return policies[static_cast<int>(policy)].name_;
+}
+
+bool find(const std::string& name, POLICY& policy) {
+    for (const auto& p : policies) {
+        if (name == p.name_) {
+            policy = p.policy_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Agents::Agents() : rows_(), cols_(), headings_(), exit_{0, 0}, first_{},
+arrived_{0}, distances_(), simd_{vectorize(true)} {
+}
+
+// Puts counts[policy] agents with each policy on random open cells of maze,
+// each facing one of the ways out of its cell.
+Agents::Agents(const Maze& maze, const Position& exit,
+const std::array<std::size_t, POLICIES>& counts, std::mt19937& rnd) :
+rows_(), cols_(), headings_(), exit_{exit}, first_{}, arrived_{0},
+distances_(), simd_{vectorize(true)} {
+    std::uniform_int_distribution<int> row(0, maze.height() - 1);
+    std::uniform_int_distribution<int> col(0, maze.width() - 1);
+
+    for (auto p = 0; p < POLICIES; p++) {
+        first_[p + 1] = first_[p] + counts[p];
+    }
+    rows_.reserve(size());
+    cols_.reserve(size());
+    headings_.reserve(size());
+
+    while (rows_.size() < size()) {
+        auto r = row(rnd);
+        auto c = col(rnd);
+        auto exits = maze.exits(r, c);
+        if (maze.at(r, c) && exits) {
+            rows_.push_back(r);
+            cols_.push_back(c);
+            headings_.push_back(__builtin_ctz(exits));
+        }
+    }
+
+    if (counts[static_cast<int>(POLICY::DISTANCE)]) {
+        Frontier frontier;
+        distances_.build(maze, { exit_ }, frontier);
+    }
+}
+
+std::size_t Agents::size() const {
+    return first_[POLICIES];
+}
+
+// The agents using policy are numbered from first(policy) up to but not
+// including last(policy).
+std::size_t Agents::first(POLICY policy) const {
+    return first_[static_cast<int>(policy)];
+}
+
+std::size_t Agents::last(POLICY policy) const {
+    return first_[static_cast<int>(policy) + 1];
+}
+
+// How many agents were at the exit after the last step().
+std::size_t Agents::arrived() const {
+    return arrived_;
+}
+
+// Uses the AVX2 version of the wall follower if on is true and the processor
+// can run it.  Returns whether it is being used.
+bool Agents::vectorize(bool on) {
+#ifdef AGENTS_AVX2
+    simd_ = on && __builtin_cpu_supports("avx2");
+#else
+    simd_ = false;
+#endif
+
+    return simd_;
+}
+
+// Moves every agent which hasn't reached the exit yet one step.  Returns the
+// number of agents moved.
+std::size_t Agents::step(const Maze& maze, std::mt19937& rnd) {
+    std::size_t moved = 0;
+
+    arrived_ = 0;
+    if (simd_) {
+        moved += followSIMD(maze, first(POLICY::FOLLOWER),
+            last(POLICY::FOLLOWER));
+    } else {
+        moved += follow(maze, first(POLICY::FOLLOWER), last(POLICY::FOLLOWER));
+    }
+    moved += descend(maze, first(POLICY::DISTANCE), last(POLICY::DISTANCE));
+    moved += wander(maze, first(POLICY::RANDOM), last(POLICY::RANDOM), rnd);
+
+    return moved;
+}
+
+// Wall followers take a step forward and then choose their next heading the
+// same way as Model::update() except for the extra step north (jump_.)  The
+// player only does that on the way from the entrance, but agents start
+// anywhere and it could take them from the cell below the entrance straight
+// out of the maze.
+std::size_t Agents::follow(const Maze& maze, std::size_t first,
+std::size_t last) {
+    std::size_t moved = 0;
+
+    for (auto i = first; i < last; i++) {
+        auto row = rows_[i];
+        auto col = cols_[i];
+        auto heading = headings_[i];
+
+        if (row == exit_.row_ && col == exit_.col_) {
+            arrived_++;
+            continue;
+        }
+
+        row += ROWS[heading];
+        col += COLS[heading];
+        const auto& turn = TURNS[heading][maze.exits(row, col)];
+        rows_[i] = row;
+        cols_[i] = col;
+        headings_[i] = static_cast<std::uint8_t>(turn.direction_);
+        moved++;
+        arrived_ += (rows_[i] == exit_.row_ && cols_[i] == exit_.col_);
+    }
+
+    return moved;
+}
+
+// The same as follow() but eight agents at a time.  The four neighbours of
+// each agent are gathered from the maze and the new headings from HEADINGS.
+// Agents already at the exit are blended back in unchanged.  Any agents left
+// over are moved by follow().
+#ifdef AGENTS_AVX2
+__attribute__((target("avx2")))
+std::size_t Agents::followSIMD(const Maze& maze, std::size_t first,
+std::size_t last) {
+    const auto* cells = reinterpret_cast<const int*>(maze.row(0));
+    auto words = _mm256_set1_epi32(maze.stride() * 2);
+    auto height = _mm256_set1_epi32(maze.height());
+    auto width = _mm256_set1_epi32(maze.width());
+    auto exitRow = _mm256_set1_epi32(exit_.row_);
+    auto exitCol = _mm256_set1_epi32(exit_.col_);
+    auto rowSteps = _mm256_setr_epi32(ROWS[0], ROWS[1], ROWS[2], ROWS[3], 0,
+        0, 0, 0);
+    auto colSteps = _mm256_setr_epi32(COLS[0], COLS[1], COLS[2], COLS[3], 0,
+        0, 0, 0);
+    auto zero = _mm256_setzero_si256();
+    auto one = _mm256_set1_epi32(1);
+    auto low = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1);
+    auto halves = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+    std::size_t moved = 0;
+    auto i = first;
+
+    for (; i + 8 <= last; i += 8) {
+        auto* r = reinterpret_cast<__m256i*>(&rows_[i]);
+        auto* c = reinterpret_cast<__m256i*>(&cols_[i]);
+        auto* h = reinterpret_cast<__m128i*>(&headings_[i]);
+        auto oldRow = _mm256_loadu_si256(r);
+        auto oldCol = _mm256_loadu_si256(c);
+        auto heading = _mm256_cvtepu8_epi32(_mm_loadl_epi64(h));
+        auto done = _mm256_and_si256(_mm256_cmpeq_epi32(oldRow, exitRow),
+            _mm256_cmpeq_epi32(oldCol, exitCol));
+
+        auto row = _mm256_add_epi32(oldRow,
+            _mm256_permutevar8x32_epi32(rowSteps, heading));
+        auto col = _mm256_add_epi32(oldCol,
+            _mm256_permutevar8x32_epi32(colSteps, heading));
+        auto east = _mm256_add_epi32(col, one);
+        auto south = _mm256_add_epi32(row, one);
+        auto west = _mm256_sub_epi32(col, one);
+        auto north = _mm256_sub_epi32(row, one);
+
+        auto exits = gather(cells, words, row, east,
+            _mm256_andnot_si256(done, _mm256_cmpgt_epi32(width, east)));
+        exits = _mm256_or_si256(exits, _mm256_slli_epi32(gather(cells, words,
+            south, col, _mm256_andnot_si256(done,
+            _mm256_cmpgt_epi32(height, south))), 1));
+        exits = _mm256_or_si256(exits, _mm256_slli_epi32(gather(cells, words,
+            row, west, _mm256_andnot_si256(done,
+            _mm256_cmpgt_epi32(col, zero))), 2));
+        exits = _mm256_or_si256(exits, _mm256_slli_epi32(gather(cells, words,
+            north, col, _mm256_andnot_si256(done,
+            _mm256_cmpgt_epi32(row, zero))), 3));
+
+        auto next = _mm256_i32gather_epi32(HEADINGS.data(),
+            _mm256_add_epi32(_mm256_slli_epi32(heading, 4), exits), 4);
+        next = _mm256_blendv_epi8(next, heading, done);
+        row = _mm256_blendv_epi8(row, oldRow, done);
+        col = _mm256_blendv_epi8(col, oldCol, done);
+
+        _mm256_storeu_si256(r, row);
+        _mm256_storeu_si256(c, col);
+        _mm_storel_epi64(h, _mm256_castsi256_si128(
+            _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(next, low),
+            halves)));
+
+        auto there = _mm256_and_si256(_mm256_cmpeq_epi32(row, exitRow),
+            _mm256_cmpeq_epi32(col, exitCol));
+        moved += 8 - __builtin_popcount(
+            _mm256_movemask_ps(_mm256_castsi256_ps(done)));
+        arrived_ += __builtin_popcount(
+            _mm256_movemask_ps(_mm256_castsi256_ps(there)));
+    }
+
+    return moved + follow(maze, i, last);
+}
+#else
+std::size_t Agents::followSIMD(const Maze& maze, std::size_t first,
+std::size_t last) {
+    return follow(maze, first, last);
+}
+#endif
+
+// Agents using the distances from the exit step to whichever neighbour is
+// closer.
+std::size_t Agents::descend(const Maze& maze, std::size_t first,
+std::size_t last) {
+    std::size_t moved = 0;
+
+    for (auto i = first; i < last; i++) {
+        GO direction;
+
+        if (rows_[i] == exit_.row_ && cols_[i] == exit_.col_) {
+            arrived_++;
+            continue;
+        }
+
+        if (distances_.next(maze, { rows_[i], cols_[i] }, direction)) {
+            auto heading = static_cast<int>(direction);
+            rows_[i] += ROWS[heading];
+            cols_[i] += COLS[heading];
+            headings_[i] = heading;
+            moved++;
+            arrived_ += (rows_[i] == exit_.row_ && cols_[i] == exit_.col_);
+        }
+    }
+
+    return moved;
+}
+
+// Random walkers step to any of their open neighbours.
+std::size_t Agents::wander(const Maze& maze, std::size_t first,
+std::size_t last, std::mt19937& rnd) {
+    std::size_t moved = 0;
+
+    for (auto i = first; i < last; i++) {
+        if (rows_[i] == exit_.row_ && cols_[i] == exit_.col_) {
+            arrived_++;
+            continue;
+        }
+
+        auto exits = maze.exits(rows_[i], cols_[i]);
+        if (!exits) {
+            continue;
+        }
+
+        auto choice = (static_cast<std::uint64_t>(rnd()) *
+            __builtin_popcount(exits)) >> 32;
+        for (; choice > 0; choice--) {
+            exits &= exits - 1;
+        }
+        auto heading = __builtin_ctz(exits);
+        rows_[i] += ROWS[heading];
+        cols_[i] += COLS[heading];
+        headings_[i] = heading;
+        moved++;
+        arrived_ += (rows_[i] == exit_.row_ && cols_[i] == exit_.col_);
+    }
+
+    return moved;
+}
@@ -0,0 +1,81 @@
+// batch -- generate many mazes at once
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "batch.h"
+#include "mazefile.h"
+
+namespace {
+    // How many mazes a thread takes to do at a time.
+    constexpr unsigned long CHUNK = 16;
+}
+
+// Generates count mazes with the seeds seed, seed + 1... shared out between
+// threads threads (or one per processor if threads is 0.)  Each thread keeps
+// one Maze and one random number generator and reuses them for every maze it
+// makes.  Each maze is the same as the one Model would make from the same
+// seed.  If fd is not -1 the mazes are saved to it in order of seed, CHUNK at
+// a time.
+bool batch(unsigned seed, unsigned long count, int rows, int cols,
+GENERATOR generator, unsigned threads, int fd) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = static_cast<unsigned>(std::min<unsigned long>(threads,
+        (count + CHUNK - 1) / CHUNK));
+
+    std::atomic<unsigned long> next{0};
+    std::atomic<bool> ok{true};
+
+    auto worker = [&]() {
+        Maze maze(rows, cols);
+        std::mt19937 rnd;
+        auto size = sizeof(MazeHeader) + maze.bytes();
+        std::vector<char> buffer(fd != -1 ? CHUNK * size : 0);
+
+        for (auto first = next.fetch_add(CHUNK); first < count && ok;
+        first = next.fetch_add(CHUNK)) {
+            auto last = std::min(first + CHUNK, count);
+            auto end = buffer.data();
+
+            for (auto i = first; i < last; i++) {
+                unsigned s = seed + i;
+
+                maze.clear();
+                rnd.seed(s);
+                generate(generator, maze, rnd, 1);
+                auto entrance = chooseEntrance(maze, rnd);
+                auto exit = chooseExit(maze, rnd);
+                maze.set(entrance.row_, entrance.col_);
+                maze.set(exit.row_, exit.col_);
+
+                if (fd != -1) {
+                    end = serialize(end,
+                        makeHeader(maze, s, generator, entrance, exit), maze);
+                }
+            }
+
+            if (fd != -1 && !writeAt(fd, first * size, buffer.data(),
+            end - buffer.data())) {
+                ok = false;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = 1u; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    return ok;
+}
@@ -0,0 +1,878 @@
+// bench -- benchmarks
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "agents.h"
+#include "bench.h"
+#include "generate.h"
+#include "junctions.h"
+#include "model.h"
+#include "solve.h"
+#include "olcPixelGameEngine.h"
+
+namespace {
+    constexpr unsigned RUNS = 5;
+
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(const Clock::time_point& start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Every generator makes a maze from each of the same RUNS seeds.
+    void generators(unsigned seed, int rows, int cols, unsigned threads) {
+        std::cout << "Generating " << rows << 'x' << cols
+            << " mazes with seeds " << seed << " to " << seed + RUNS - 1
+            << "\n\n" << std::left << std::setw(12) << "algorithm"
+            << std::right << std::setw(12) << "seconds" << std::setw(16)
+            << "cells/s" << '\n';
+
+        for (auto g = 0; g < GENERATORS; g++) {
+            auto generator = static_cast<GENERATOR>(g);
+            double total = 0.0;
+
+            for (auto run = 0u; run < RUNS; run++) {
+                Maze maze(rows, cols);
+                std::mt19937 rnd{seed + run};
+
+                auto start = Clock::now();
+                generate(generator, maze, rnd, threads);
+                total += seconds(start);
+            }
+
+            std::cout << std::left << std::setw(12) << name(generator)
+                << std::right << std::setw(12) << total / RUNS
+                << std::setw(16)
+                << static_cast<double>(rows) * cols * RUNS / total << '\n';
+        }
+    }
+
+    // How the time taken to generate a uniform spanning tree with Wilson's
+    // algorithm grows with the size of the maze.  The size starts at 17x17
+    // and doubles until it reaches the size asked for.
+    void wilson(unsigned seed, int rows, int cols, unsigned) {
+        std::cout << "Generating mazes with wilson, seed " << seed << "\n\n"
+            << std::left << std::setw(16) << "size" << std::right
+            << std::setw(12) << "seconds" << std::setw(16) << "cells/s"
+            << '\n';
+
+        for (auto size = 16; ; size *= 2) {
+            auto r = std::min(size + 1, rows);
+            auto c = std::min(size + 1, cols);
+            Maze maze(r, c);
+            std::mt19937 rnd{seed};
+
+            auto start = Clock::now();
+            generate(GENERATOR::WILSON, maze, rnd);
+            auto elapsed = seconds(start);
+
+            std::cout << std::left << std::setw(16)
+                << std::to_string(r) + 'x' + std::to_string(c) << std::right
+                << std::setw(12) << elapsed << std::setw(16)
+                << static_cast<double>(r) * c / elapsed << std::endl;
+
+            if (r == rows && c == cols) {
+                break;
+            }
+        }
+    }
+
+    // The tiled generator with from 1 up to threads threads (or one per
+    // processor if threads is 0.)  The maze should come out the same each
+    // time.
+    void tiled(unsigned seed, int rows, int cols, unsigned threads) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        std::cout << "Generating a " << rows << 'x' << cols
+            << " maze with tiled, seed " << seed << "\n\n" << std::setw(8)
+            << "threads" << std::setw(12) << "seconds" << std::setw(16)
+            << "cells/s" << std::setw(10) << "speedup" << std::setw(8)
+            << "same" << '\n';
+
+        Maze first(rows, cols);
+        double single = 0.0;
+
+        for (auto t = 1u; ; t = std::min(t * 2, threads)) {
+            Maze maze(rows, cols);
+            std::mt19937 rnd{seed};
+
+            auto start = Clock::now();
+            generate(GENERATOR::TILED, maze, rnd, t);
+            auto elapsed = seconds(start);
+
+            if (t == 1) {
+                first = maze;
+                single = elapsed;
+            }
+
+            auto same = std::equal(maze.row(0), maze.row(0) +
+                maze.bytes() / sizeof(Maze::Word), first.row(0));
+
+            std::cout << std::setw(8) << t << std::setw(12) << elapsed
+                << std::setw(16) << static_cast<double>(rows) * cols / elapsed
+                << std::setw(10) << single / elapsed << std::setw(8)
+                << (same ? "yes" : "NO") << std::endl;
+
+            if (t == threads) {
+                break;
+            }
+        }
+    }
+
+    // The wall follower walks from the entrance to the exit of mazes made by
+    // every generator from the same RUNS seeds.
+    void follower(unsigned seed, int rows, int cols, unsigned threads) {
+        std::cout << "Following the wall through " << rows << 'x' << cols
+            << " mazes with seeds " << seed << " to " << seed + RUNS - 1
+            << "\n\n" << std::left << std::setw(12) << "algorithm"
+            << std::right << std::setw(12) << "seconds" << std::setw(14)
+            << "steps" << std::setw(16) << "steps/s" << '\n';
+
+        for (auto g = 0; g < GENERATORS; g++) {
+            auto generator = static_cast<GENERATOR>(g);
+            double total = 0.0;
+            std::size_t steps = 0;
+
+            for (auto run = 0u; run < RUNS; run++) {
+                Model model(seed + run, rows, cols, generator, threads);
+
+                auto start = Clock::now();
+                steps += model.run();
+                total += seconds(start);
+            }
+
+            std::cout << std::left << std::setw(12) << name(generator)
+                << std::right << std::setw(12) << total / RUNS
+                << std::setw(14) << steps / RUNS << std::setw(16)
+                << steps / total << std::endl;
+        }
+    }
+
+    // A hundred thousand agents with each policy (and then all of them
+    // together) take TICKS steps through a maze made by the backtracker.
+    void agents(unsigned seed, int rows, int cols, unsigned) {
+        constexpr std::size_t AGENTS = 100'000;
+        constexpr int TICKS = 100;
+        Model model(seed, rows, cols, GENERATOR::BACKTRACKER);
+
+        std::cout << AGENTS << " agents of each policy taking " << TICKS
+            << " steps in a " << rows << 'x' << cols
+            << " maze made by backtracker, seed " << seed << "\n\n"
+            << std::left << std::setw(12) << "policy" << std::right
+            << std::setw(12) << "seconds" << std::setw(14) << "steps"
+            << std::setw(16) << "steps/s" << '\n';
+
+        for (auto p = 0; p <= POLICIES; p++) {
+            std::array<std::size_t, POLICIES> counts{};
+            if (p < POLICIES) {
+                counts[p] = AGENTS;
+            } else {
+                counts.fill(AGENTS);
+            }
+            std::mt19937 rnd{seed};
+            Agents agents(model.maze_, model.exit_, counts, rnd);
+            std::size_t steps = 0;
+
+            auto start = Clock::now();
+            for (auto tick = 0; tick < TICKS; tick++) {
+                steps += agents.step(model.maze_, rnd);
+            }
+            auto elapsed = seconds(start);
+
+            std::cout << std::left << std::setw(12)
+                << ((p < POLICIES) ? name(static_cast<POLICY>(p)) : "all")
+                << std::right << std::setw(12) << elapsed << std::setw(14)
+                << steps << std::setw(16) << steps / elapsed << std::endl;
+        }
+    }
+
+    // The same wall following agents take TICKS steps with the scalar and
+    // the AVX2 versions of Agents::step() which should leave them all in the
+    // same places.
+    void simd(unsigned seed, int rows, int cols, unsigned) {
+        constexpr std::size_t AGENTS = 100'000;
+        constexpr int TICKS = 100;
+        Model model(seed, rows, cols, GENERATOR::BACKTRACKER);
+        std::array<std::size_t, POLICIES> counts{};
+        counts[static_cast<int>(POLICY::FOLLOWER)] = AGENTS;
+
+        std::cout << AGENTS << " wall following agents taking " << TICKS
+            << " steps in a " << rows << 'x' << cols
+            << " maze made by backtracker, seed " << seed << "\n\n"
+            << std::left << std::setw(12) << "version" << std::right
+            << std::setw(12) << "seconds" << std::setw(16) << "steps/s"
+            << std::setw(10) << "speedup" << std::setw(8) << "same" << '\n';
+
+        Agents first;
+        double scalar = 0.0;
+
+        for (auto simd : { false, true }) {
+            std::mt19937 rnd{seed};
+            Agents agents(model.maze_, model.exit_, counts, rnd);
+            if (agents.vectorize(simd) != simd) {
+                std::cout << "This processor can't run the AVX2 version."
+                    << std::endl;
+                break;
+            }
+            std::size_t steps = 0;
+
+            auto start = Clock::now();
+            for (auto tick = 0; tick < TICKS; tick++) {
+                steps += agents.step(model.maze_, rnd);
+            }
+            auto elapsed = seconds(start);
+
+            if (!simd) {
+                first = agents;
+                scalar = elapsed;
+            }
+            auto same = agents.rows_ == first.rows_ &&
+                agents.cols_ == first.cols_ &&
+                agents.headings_ == first.headings_ &&
+                agents.arrived() == first.arrived();
+
+            std::cout << std::left << std::setw(12)
+                << (simd ? "avx2" : "scalar") << std::right << std::setw(12)
+                << elapsed << std::setw(16) << steps / elapsed << std::setw(10)
+                << scalar / elapsed << std::setw(8) << (same ? "yes" : "NO")
+                << std::endl;
+        }
+    }
+
+    // Flips random cells of a maze made by the backtracker, walls to open and
+    // open cells to walls, and then flips them back again, in batches,
+    // keeping the distances from the exit up to date by repairing them and by
+    // working them out again from scratch.  The two should come out the same
+    // after every batch.
+    void edits(unsigned seed, int rows, int cols, unsigned) {
+        constexpr int BATCHES = 100;
+        Model model(seed, rows, cols, GENERATOR::BACKTRACKER);
+        std::uniform_int_distribution<int> row(1, rows - 2);
+        std::uniform_int_distribution<int> col(1, cols - 2);
+
+        std::cout << "Changing walls in a " << rows << 'x' << cols
+            << " maze made by backtracker, seed " << seed << "\n\n"
+            << std::setw(8) << "batch" << std::setw(14) << "repair"
+            << std::setw(16) << "edits/s" << std::setw(14) << "rebuild"
+            << std::setw(16) << "edits/s" << std::setw(10) << "speedup"
+            << std::setw(8) << "same" << '\n';
+
+        Frontier frontier;
+        Distances repaired;
+        Distances rebuilt;
+
+        for (auto size : { 1, 16, 256 }) {
+            Maze maze = model.maze_;
+            std::mt19937 rnd{seed};
+            double repair = 0.0;
+            double rebuild = 0.0;
+
+            auto same = true;
+
+            std::vector<Edit> edits;
+
+            repaired.build(maze, { model.exit_ }, frontier);
+            for (auto batch = 0; batch < BATCHES; batch++) {
+                if (batch % 2) {
+                    for (auto& edit : edits) {
+                        edit.open_ = !edit.open_;
+                    }
+                } else {
+                    edits.clear();
+                    while (edits.size() < static_cast<std::size_t>(size)) {
+                        Position cell{ row(rnd), col(rnd) };
+                        if (cell.row_ != model.exit_.row_ ||
+                        cell.col_ != model.exit_.col_) {
+                            edits.push_back({ cell,
+                                !maze.at(cell.row_, cell.col_) });
+                        }
+                    }
+                }
+
+                auto start = Clock::now();
+                repaired.apply(maze, edits, frontier);
+                repair += seconds(start);
+
+                start = Clock::now();
+                rebuilt.build(maze, { model.exit_ }, frontier);
+                rebuild += seconds(start);
+
+                for (auto r = 0; r < rows; r++) {
+                    for (auto c = 0; c < cols; c++) {
+                        same = same && repaired.at(r, c) == rebuilt.at(r, c);
+                    }
+                }
+            }
+
+            std::cout << std::setw(8) << size << std::setw(14) << repair
+                << std::setw(16) << size * BATCHES / repair << std::setw(14)
+                << rebuild << std::setw(16) << size * BATCHES / rebuild
+                << std::setw(10) << rebuild / repair << std::setw(8)
+                << (same ? "yes" : "NO") << std::endl;
+        }
+    }
+
+    // Builds the graph of junctions of a maze made by each of the generators
+    // (except the slow carver) from the same seed and shows how much smaller
+    // it is than the maze.  Then times finding the way from the entrance to
+    // the exit on the graph and, if it is small enough, the distances between
+    // every pair of junctions.
+    void junctions(unsigned seed, int rows, int cols, unsigned threads) {
+        constexpr std::size_t PAIRS = 4096;
+
+        std::cout << "Junctions of " << rows << 'x' << cols
+            << " mazes with seed " << seed << "\n\n" << std::left
+            << std::setw(12) << "algorithm" << std::right << std::setw(12)
+            << "open cells" << std::setw(10) << "nodes" << std::setw(10)
+            << "edges" << std::setw(8) << "ratio" << std::setw(12) << "build"
+            << std::setw(12) << "dijkstra" << std::setw(12) << "tremaux"
+            << std::setw(12) << "all pairs" << '\n';
+
+        Junctions graph;
+        std::vector<std::uint32_t> path;
+        std::vector<std::uint32_t> distances;
+
+        for (auto g = 1; g < GENERATORS; g++) {
+            auto generator = static_cast<GENERATOR>(g);
+            Model model(seed, rows, cols, generator, threads);
+            std::size_t open = 0;
+            for (auto r = 0; r < rows; r++) {
+                open += model.maze_.count(r, 0, cols);
+            }
+
+            auto start = Clock::now();
+            graph.build(model.maze_, model.entrance_, model.exit_);
+            auto built = seconds(start);
+
+            auto from = graph.node(model.entrance_);
+            auto to = graph.node(model.exit_);
+            std::size_t count;
+            start = Clock::now();
+            graph.dijkstra(from, to, path, count);
+            auto shortest = seconds(start);
+
+            start = Clock::now();
+            graph.tremaux(from, to, path, count);
+            auto explored = seconds(start);
+
+            std::cout << std::left << std::setw(12) << name(generator)
+                << std::right << std::setw(12) << open << std::setw(10)
+                << graph.nodes() << std::setw(10) << graph.edges()
+                << std::setw(8) << std::setprecision(3)
+                << static_cast<double>(open) / graph.nodes()
+                << std::setprecision(6) << std::setw(12) << built
+                << std::setw(12) << shortest << std::setw(12) << explored;
+
+            if (graph.nodes() <= PAIRS) {
+                start = Clock::now();
+                graph.allPairs(distances);
+                std::cout << std::setw(12) << seconds(start);
+            } else {
+                std::cout << std::setw(12) << '-';
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // Builds the distances from the exit of a maze made by the backtracker and
+    // then asks which way to go from a million random open cells.
+    void distances(unsigned seed, int rows, int cols, unsigned) {
+        constexpr int QUERIES = 1'000'000;
+        Model model(seed, rows, cols, GENERATOR::BACKTRACKER);
+        Frontier frontier;
+        Distances distances;
+
+        auto start = Clock::now();
+        auto reached = distances.build(model.maze_, { model.exit_ },
+            frontier);
+        auto built = seconds(start);
+
+        std::vector<Position> cells;
+        std::uniform_int_distribution<int> row(0, rows - 1);
+        std::uniform_int_distribution<int> col(0, cols - 1);
+        while (cells.size() < QUERIES) {
+            Position cell{ row(model.rnd_), col(model.rnd_) };
+            if (model.maze_.at(cell.row_, cell.col_)) {
+                cells.push_back(cell);
+            }
+        }
+
+        unsigned moves[4] = { 0, 0, 0, 0 };
+        start = Clock::now();
+        for (const auto& cell : cells) {
+            GO direction;
+            if (distances.next(model.maze_, cell, direction)) {
+                moves[static_cast<int>(direction)]++;
+            }
+        }
+        auto queried = seconds(start);
+
+        std::cout << "Distances from the exit of a " << rows << 'x' << cols
+            << " maze made by backtracker, seed " << seed << "\n\n"
+            << "built in " << built << "s (" << reached << " cells reached, "
+            << distances.bytes() << " bytes)\n" << QUERIES << " next moves in "
+            << queried << "s (" << QUERIES / queried << " moves/s; "
+            << moves[0] << " east, " << moves[1] << " south, " << moves[2]
+            << " west, " << moves[3] << " north)" << std::endl;
+    }
+
+    // Finds every cell reachable from the entrance of mazes made by the
+    // backtracker and kruskal from the same RUNS seeds, first with Wavefront
+    // and then one cell at a time with Distances.  They should agree on how
+    // many cells there are, how far away the furthest is and how far away
+    // the exit is.
+    void wavefront(unsigned seed, int rows, int cols, unsigned) {
+        std::cout << "Flooding " << rows << 'x' << cols
+            << " mazes from the entrance with seeds " << seed << " to "
+            << seed + RUNS - 1 << "\n\n" << std::left << std::setw(12)
+            << "algorithm" << std::right << std::setw(12) << "levels"
+            << std::setw(12) << "wavefront" << std::setw(16) << "levels/s"
+            << std::setw(12) << "scalar" << std::setw(10) << "speedup"
+            << std::setw(8) << "same" << '\n';
+
+        Wavefront wave;
+        Frontier frontier;
+        Distances distances;
+
+        for (auto generator : { GENERATOR::BACKTRACKER, GENERATOR::KRUSKAL }) {
+            double bits = 0.0;
+            double cells = 0.0;
+            std::size_t levels = 0;
+            auto same = true;
+
+            for (auto run = 0u; run < RUNS; run++) {
+                Model model(seed + run, rows, cols, generator);
+
+                auto start = Clock::now();
+                auto reached = wave.flood(model.maze_, model.entrance_);
+                bits += seconds(start);
+                levels += wave.levels();
+
+                start = Clock::now();
+                auto counted = distances.build(model.maze_,
+                    { model.entrance_ }, frontier);
+                cells += seconds(start);
+
+                std::uint32_t furthest = 0;
+                for (auto r = 0; r < rows; r++) {
+                    for (auto c = 0; c < cols; c++) {
+                        auto d = distances.at(r, c);
+                        if (d != Distances::UNREACHABLE) {
+                            furthest = std::max(furthest, d);
+                        }
+                    }
+                }
+
+                same = same && reached == counted && wave.levels() == furthest &&
+                    wave.distance(model.maze_, model.entrance_, model.exit_) ==
+                    distances.at(model.exit_.row_, model.exit_.col_);
+            }
+
+            std::cout << std::left << std::setw(12) << name(generator)
+                << std::right << std::setw(12) << levels / RUNS
+                << std::setw(12) << bits / RUNS << std::setw(16)
+                << levels / bits << std::setw(12) << cells / RUNS
+                << std::setw(10) << cells / bits << std::setw(8)
+                << (same ? "yes" : "NO") << std::endl;
+        }
+    }
+
+    // Each solver finds a path through the mazes made from the same RUNS seeds
+    // by the backtracker, first as they are and then after filling in their
+    // dead ends (which is included in the time.)  The wall follower's time is
+    // for walking all the way to the exit.  The length of every other path is
+    // checked against the one found by breadth-first search.
+    void solvers(unsigned seed, int rows, int cols, unsigned) {
+        std::vector<Model> models;
+        std::vector<std::size_t> shortest;
+        Workspace workspace;
+
+        for (auto run = 0u; run < RUNS; run++) {
+            models.emplace_back(seed + run, rows, cols, GENERATOR::BACKTRACKER);
+
+            Model m = models.back();
+            m.solve(SOLVER::BFS, workspace);
+            shortest.push_back(m.solution_.path_.size());
+        }
+
+        std::cout << "Solving " << rows << 'x' << cols
+            << " mazes made by backtracker with seeds " << seed << " to "
+            << seed + RUNS - 1 << "\n\n" << std::left << std::setw(20)
+            << "solver" << std::right << std::setw(12) << "seconds"
+            << std::setw(16) << "cells/s" << std::setw(14) << "steps"
+            << std::setw(14) << "expanded" << std::setw(14) << "filled"
+            << std::setw(10) << "shortest" << '\n';
+
+        for (auto fill : { false, true }) {
+            for (auto s = 0; s < SOLVERS; s++) {
+                auto solver = static_cast<SOLVER>(s);
+                double total = 0.0;
+                std::size_t steps = 0;
+                std::size_t expanded = 0;
+                std::size_t filled = 0;
+                bool same = true;
+
+                for (auto run = 0u; run < RUNS; run++) {
+                    Model m = models[run];
+
+                    auto start = Clock::now();
+                    if (fill) {
+                        filled += m.fillDeadEnds(workspace);
+                    }
+                    m.solve(solver, workspace);
+                    if (solver == SOLVER::FOLLOWER) {
+                        steps += m.run();
+                    } else {
+                        steps += m.solution_.path_.size() - 1;
+                        expanded += m.solution_.expanded_;
+                    }
+                    total += seconds(start);
+
+                    if (solver != SOLVER::FOLLOWER &&
+                    m.solution_.path_.size() != shortest[run]) {
+                        same = false;
+                    }
+                }
+
+                std::cout << std::left << std::setw(20)
+                    << std::string(name(solver)) + (fill ? "+fill" : "")
+                    << std::right << std::setw(12) << total / RUNS
+                    << std::setw(16)
+                    << static_cast<double>(rows) * cols * RUNS / total
+                    << std::setw(14) << steps / RUNS << std::setw(14)
+                    << expanded / RUNS << std::setw(14) << filled / RUNS
+                    << std::setw(10) << ((solver == SOLVER::FOLLOWER) ? "-" :
+                    (same ? "yes" : "NO")) << std::endl;
+            }
+        }
+    }
+
+    // Sprites of each size and scale are drawn all over a draw target first a
+    // pixel at a time, as DrawSprite() used to, and then with DrawSprite()
+    // which copies whole rows.  4x4 is the size of a cell in the display.
+    void sprites(unsigned seed, int, int, unsigned) {
+        constexpr int TARGET = 512;
+        constexpr int PASSES = 100;
+        struct Size {
+            int size_;
+            std::uint32_t scale_;
+        };
+        const std::array<Size, 6> sizes {
+            Size{4, 1}, Size{4, 2}, Size{4, 4}, Size{8, 1}, Size{16, 1},
+            Size{32, 1}
+        };
+        std::mt19937 rnd{seed};
+        olc::PixelGameEngine engine;
+        olc::Sprite before(TARGET, TARGET);
+        olc::Sprite after(TARGET, TARGET);
+
+        std::cout << "Drawing sprites all over a " << TARGET << 'x' << TARGET
+            << " target " << PASSES << " times\n\n" << std::setw(6) << "size"
+            << std::setw(7) << "scale" << std::setw(16) << "per pixel"
+            << std::setw(16) << "sprites/s" << std::setw(16) << "row copy"
+            << std::setw(16) << "sprites/s" << std::setw(10) << "speedup"
+            << std::setw(8) << "same" << '\n';
+
+        for (const auto& size : sizes) {
+            olc::Sprite sprite(size.size_, size.size_);
+            for (auto y = 0; y < size.size_; y++) {
+                for (auto x = 0; x < size.size_; x++) {
+                    sprite.SetPixel(x, y, olc::Pixel(rnd()));
+                }
+            }
+            auto step = size.size_ * static_cast<int>(size.scale_);
+            auto count = static_cast<double>(PASSES) *
+                ((TARGET + step - 1) / step) * ((TARGET + step - 1) / step);
+
+            engine.SetDrawTarget(&before);
+            auto start = Clock::now();
+            for (auto pass = 0; pass < PASSES; pass++) {
+                for (auto y = 0; y < TARGET; y += step) {
+                    for (auto x = 0; x < TARGET; x += step) {
+                        for (auto i = 0; i < size.size_; i++) {
+                            for (auto j = 0; j < size.size_; j++) {
+                                for (auto is = 0u; is < size.scale_; is++) {
+                                    for (auto js = 0u; js < size.scale_; js++) {
+                                        engine.Draw(x + i * size.scale_ + is,
+                                            y + j * size.scale_ + js,
+                                            sprite.GetPixel(i, j));
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            auto pixel = seconds(start);
+
+            engine.SetDrawTarget(&after);
+            start = Clock::now();
+            for (auto pass = 0; pass < PASSES; pass++) {
+                for (auto y = 0; y < TARGET; y += step) {
+                    for (auto x = 0; x < TARGET; x += step) {
+                        engine.DrawSprite(x, y, &sprite, size.scale_);
+                    }
+                }
+            }
+            auto row = seconds(start);
+
+            auto same = std::equal(before.GetData(),
+                before.GetData() + TARGET * TARGET, after.GetData(),
+                [](const olc::Pixel& a, const olc::Pixel& b) {
+                    return a == b;
+                });
+
+            std::cout << std::setw(6) << size.size_ << std::setw(7)
+                << size.scale_ << std::setw(16) << pixel << std::setw(16)
+                << count / pixel << std::setw(16) << row << std::setw(16)
+                << count / row << std::setw(10) << pixel / row << std::setw(8)
+                << (same ? "yes" : "NO") << std::endl;
+        }
+    }
+
+    // Translucent pixels drawn over a draw target the way Draw() used to,
+    // with floating point, and then by FillRect() and DrawSprite() which now
+    // blend whole rows in fixed point.  The results can be off by one.
+    void blends(unsigned seed, int, int, unsigned) {
+        constexpr int TARGET = 1024;
+        constexpr int PASSES = 20;
+        std::mt19937 rnd{seed};
+        olc::PixelGameEngine engine;
+        olc::Sprite before(TARGET, TARGET);
+        olc::Sprite after(TARGET, TARGET);
+        olc::Sprite overlay(TARGET, TARGET);
+        olc::Sprite tile(4, 4);
+        const olc::Pixel colour(255, 64, 0, 96);
+
+        for (auto y = 0; y < TARGET; y++) {
+            for (auto x = 0; x < TARGET; x++) {
+                overlay.SetPixel(x, y, olc::Pixel(rnd()));
+            }
+        }
+        for (auto y = 0; y < 4; y++) {
+            for (auto x = 0; x < 4; x++) {
+                tile.SetPixel(x, y, olc::Pixel(rnd()));
+            }
+        }
+
+        auto old = [](olc::Sprite& target, int x, int y, olc::Pixel p) {
+            auto d = target.GetPixel(x, y);
+            auto a = p.a / 255.0f * 0.75f;
+            auto c = 1.0f - a;
+            target.SetPixel(x, y, olc::Pixel(
+                static_cast<std::uint8_t>(a * p.r + c * d.r),
+                static_cast<std::uint8_t>(a * p.g + c * d.g),
+                static_cast<std::uint8_t>(a * p.b + c * d.b)));
+        };
+
+        std::cout << "Blending translucent pixels over a " << TARGET << 'x'
+            << TARGET << " target " << PASSES << " times\n\n" << std::left
+            << std::setw(12) << "primitive" << std::right << std::setw(16)
+            << "float pixels/s" << std::setw(16) << "span pixels/s"
+            << std::setw(10) << "speedup" << std::setw(10) << "max diff"
+            << '\n';
+
+        for (const auto* primitive : { "fillrect", "tile", "overlay" }) {
+            std::string kind = primitive;
+            auto slowPass = [&]() {
+                for (auto x = 0; x < TARGET; x++) {
+                    for (auto y = 0; y < TARGET; y++) {
+                        if (kind == "fillrect") {
+                            old(before, x, y, colour);
+                        } else if (kind == "tile") {
+                            old(before, x, y, tile.GetPixel(x % 4, y % 4));
+                        } else {
+                            old(before, x, y, overlay.GetPixel(x, y));
+                        }
+                    }
+                }
+            };
+            auto fastPass = [&]() {
+                if (kind == "fillrect") {
+                    engine.FillRect(0, 0, TARGET, TARGET, colour);
+                } else if (kind == "tile") {
+                    for (auto y = 0; y < TARGET; y += 4) {
+                        for (auto x = 0; x < TARGET; x += 4) {
+                            engine.DrawSprite(x, y, &tile);
+                        }
+                    }
+                } else {
+                    engine.DrawSprite(0, 0, &overlay);
+                }
+            };
+
+            auto start = Clock::now();
+            for (auto pass = 0; pass < PASSES; pass++) {
+                slowPass();
+            }
+            auto slow = seconds(start);
+
+            engine.SetDrawTarget(&after);
+            engine.SetPixelMode(olc::Pixel::ALPHA);
+            engine.SetPixelBlend(0.75f);
+            start = Clock::now();
+            for (auto pass = 0; pass < PASSES; pass++) {
+                fastPass();
+            }
+            auto fast = seconds(start);
+
+            // Rounding differences build up pass after pass so only compare
+            // the results of one.
+            std::fill(before.GetData(), before.GetData() + TARGET * TARGET,
+                olc::Pixel(0, 0, 128));
+            std::fill(after.GetData(), after.GetData() + TARGET * TARGET,
+                olc::Pixel(0, 0, 128));
+            slowPass();
+            fastPass();
+            engine.SetPixelMode(olc::Pixel::NORMAL);
+
+            auto diff = 0;
+            for (auto i = 0; i < TARGET * TARGET; i++) {
+                const auto& a = before.GetData()[i];
+                const auto& b = after.GetData()[i];
+                diff = std::max({diff, std::abs(a.r - b.r),
+                    std::abs(a.g - b.g), std::abs(a.b - b.b)});
+            }
+
+            auto pixels = static_cast<double>(PASSES) * TARGET * TARGET;
+            std::cout << std::left << std::setw(12) << kind << std::right
+                << std::setw(16) << pixels / slow << std::setw(16)
+                << pixels / fast << std::setw(10) << slow / fast
+                << std::setw(10) << diff << std::endl;
+        }
+    }
+
+    // Clear() and FillRect() on draw targets from one which fits in the
+    // cache to ones which don't, compared with filling a pixel at a time as
+    // they used to.  FillRect() leaves a one pixel border so its rows don't
+    // start on a nice boundary.
+    void fills(unsigned, int, int, unsigned) {
+        constexpr double BYTES = 256.0 * 1024 * 1024;
+        const std::array<int, 3> sizes { 512, 2048, 4096 };
+        olc::PixelGameEngine engine;
+
+        std::cout << "Filling draw targets with about " << BYTES / 1e9
+            << " GB of pixels (GB/s)\n\n" << std::setw(6) << "size"
+            << std::setw(8) << "MB" << std::setw(14) << "clear pixel"
+            << std::setw(14) << "clear simd" << std::setw(14) << "rect pixel"
+            << std::setw(14) << "rect simd" << std::setw(8) << "same" << '\n';
+
+        for (auto size : sizes) {
+            olc::Sprite before(size, size);
+            olc::Sprite after(size, size);
+            auto pixels = static_cast<std::size_t>(size) * size;
+            auto bytes = static_cast<double>(pixels * sizeof(olc::Pixel));
+            auto reps = std::max(1, static_cast<int>(BYTES / bytes));
+            auto inner = static_cast<double>(size - 2) * (size - 2) *
+                sizeof(olc::Pixel);
+            std::array<double, 4> rates{};
+
+            auto start = Clock::now();
+            for (auto rep = 0; rep < reps; rep++) {
+                auto* m = before.GetData();
+                for (std::size_t i = 0; i < pixels; i++) {
+                    m[i] = olc::Pixel(rep);
+                }
+            }
+            rates[0] = reps * bytes / seconds(start) / 1e9;
+
+            engine.SetDrawTarget(&after);
+            start = Clock::now();
+            for (auto rep = 0; rep < reps; rep++) {
+                engine.Clear(olc::Pixel(rep));
+            }
+            rates[1] = reps * bytes / seconds(start) / 1e9;
+            auto same = std::equal(before.GetData(), before.GetData() + pixels,
+                after.GetData());
+
+            engine.SetDrawTarget(&before);
+            start = Clock::now();
+            for (auto rep = 0; rep < reps; rep++) {
+                for (auto x = 1; x < size - 1; x++) {
+                    for (auto y = 1; y < size - 1; y++) {
+                        engine.Draw(x, y, olc::Pixel(~rep));
+                    }
+                }
+            }
+            rates[2] = reps * inner / seconds(start) / 1e9;
+
+            engine.SetDrawTarget(&after);
+            start = Clock::now();
+            for (auto rep = 0; rep < reps; rep++) {
+                engine.FillRect(1, 1, size - 2, size - 2, olc::Pixel(~rep));
+            }
+            rates[3] = reps * inner / seconds(start) / 1e9;
+            same = same && std::equal(before.GetData(),
+                before.GetData() + pixels, after.GetData());
+
+            std::cout << std::setw(6) << size << std::setw(8)
+                << bytes / (1024 * 1024);
+            for (auto rate : rates) {
+                std::cout << std::setw(14) << rate;
+            }
+            std::cout << std::setw(8) << (same ? "yes" : "NO") << std::endl;
+        }
+    }
+
+    struct Benchmark {
+        const char* name_;
+        void (*run_)(unsigned, int, int, unsigned);
+    };
+
+    const std::array<Benchmark, 14> all {
+        Benchmark{"agents", agents},
+        Benchmark{"blend", blends},
+        Benchmark{"distance", distances},
+        Benchmark{"edit", edits},
+        Benchmark{"fill", fills},
+        Benchmark{"follower", follower},
+        Benchmark{"generate", generators},
+        Benchmark{"junctions", junctions},
+        Benchmark{"simd", simd},
+        Benchmark{"solve", solvers},
+        Benchmark{"sprite", sprites},
+        Benchmark{"tiled", tiled},
+        Benchmark{"wavefront", wavefront},
+        Benchmark{"wilson", wilson}
+    };
+}
+
+// The names of all the benchmarks separated by commas.
+std::string benchmarks() {
+    std::string result;
+
+    for (const auto& b : all) {
+        if (!result.empty()) {
+            result += ", ";
+        }
+        result += b.name_;
+    }
+
+    return result;
+}
+
+bool benchmark(const std::string& name, unsigned seed, int rows, int cols,
+unsigned threads) {
+    for (const auto& b : all) {
+        if (name == b.name_) {
+            b.run_(seed, rows, cols, threads);
+            return true;
+        }
+    }
+
+    return false;
+}
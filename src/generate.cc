@@ -0,0 +1,638 @@
+// generate -- maze generation algorithms
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "generate.h"
+
+namespace {
+    struct Generator {
+        GENERATOR generator_;
+        const char* name_;
+        void (*generate_)(Maze&, std::mt19937&);
+    };
+
+    const std::array<Generator, GENERATORS> generators {
+        Generator{GENERATOR::CARVER, "carver", carve},
+        Generator{GENERATOR::BACKTRACKER, "backtracker", backtrack},
+        Generator{GENERATOR::ELLER, "eller", eller},
+        Generator{GENERATOR::KRUSKAL, "kruskal", kruskal},
+        Generator{GENERATOR::WILSON, "wilson", wilson},
+        Generator{GENERATOR::TILED, "tiled", tiled}
+    };
+
+    // Random numbers of a few bits each, taken 32 bits at a time from the
+    // underlying generator.
+    class RandomBits {
+    public:
+        explicit RandomBits(std::mt19937& rnd) : rnd_{rnd}, bits_{0}, left_{0} {
+        }
+
+        unsigned operator()(int count) {
+            if (left_ < count) {
+                bits_ = rnd_();
+                left_ = 32;
+            }
+            left_ -= count;
+            unsigned result = bits_ & ((1u << count) - 1);
+            bits_ >>= count;
+            return result;
+        }
+
+    private:
+        std::mt19937& rnd_;
+        std::uint32_t bits_;
+        int left_;
+    };
+
+    void open(std::vector<Maze::Word>& row, int col) {
+        row[col / Maze::BITS] |= Maze::Word{1} << (col % Maze::BITS);
+    }
+
+    // A disjoint set forest kept in one flat array.  Each entry is either the
+    // parent of that element or, for the root of a set, the rank of the set
+    // as a negative number.  Finding uses path halving and joining is by
+    // rank.
+    template<typename Index>
+    class DisjointSet {
+    public:
+        explicit DisjointSet(Index size) : parent_(size, -1) {
+        }
+
+        Index find(Index i) {
+            while (parent_[i] >= 0) {
+                auto up = parent_[i];
+                if (parent_[up] >= 0) {
+                    parent_[i] = parent_[up];
+                }
+                i = parent_[i];
+            }
+
+            return i;
+        }
+
+        // Returns false if a and b were already in the same set.
+        bool join(Index a, Index b) {
+            a = find(a);
+            b = find(b);
+
+            if (a == b) {
+                return false;
+            }
+
+            if (parent_[a] > parent_[b]) {
+                std::swap(a, b);
+            }
+            if (parent_[a] == parent_[b]) {
+                parent_[a]--;
+            }
+            parent_[b] = a;
+
+            return true;
+        }
+
+        void prefetch(Index i) const {
+            __builtin_prefetch(&parent_[i]);
+        }
+
+    private:
+        std::vector<Index> parent_;
+    };
+
+    // A random number from 0 to n - 1.  Scaling with a multiply rather than
+    // rejecting out of range values as std::uniform_int_distribution does is
+    // very slightly biased but much quicker.
+    std::size_t below(std::size_t n, std::mt19937& rnd) {
+        if (n > UINT32_MAX) {
+            return std::uniform_int_distribution<std::size_t>(0, n - 1)(rnd);
+        }
+
+        return (static_cast<std::uint64_t>(rnd()) * n) >> 32;
+    }
+
+    // A Fisher-Yates shuffle which picks the elements to swap a few steps
+    // ahead so they can be prefetched.  This matters once v is much larger
+    // than the cache.
+    template<typename T>
+    void shuffle(std::vector<T>& v, std::mt19937& rnd) {
+        constexpr std::size_t AHEAD = 16;
+        std::array<std::size_t, AHEAD> targets;
+        auto n = v.size();
+
+        for (std::size_t k = 0; k < AHEAD && k + 1 < n; k++) {
+            targets[k] = below(n - k, rnd);
+        }
+
+        for (std::size_t i = n, k = 0; i > 1; i--, k = (k + 1) % AHEAD) {
+            auto j = targets[k];
+
+            if (i > AHEAD + 1) {
+                targets[k] = below(i - AHEAD, rnd);
+                __builtin_prefetch(&v[targets[k]]);
+            }
+            std::swap(v[i - 1], v[j]);
+        }
+    }
+
+    // Each odd cell is numbered in row-major order.  The wall to the east of
+    // cell n is edge 2n and the wall to the south of it is edge 2n + 1.
+    template<typename Index>
+    void joinCells(Maze& maze, std::mt19937& rnd) {
+        Index rows = maze.height() / 2;
+        Index cols = maze.width() / 2;
+        Index cells = rows * cols;
+
+        std::vector<Index> edges;
+        edges.reserve(2 * cells - rows - cols);
+        for (Index row = 0, cell = 0; row < rows; row++) {
+            for (Index col = 0; col < cols; col++, cell++) {
+                if (col != cols - 1) {
+                    edges.push_back(2 * cell);
+                }
+                if (row != rows - 1) {
+                    edges.push_back(2 * cell + 1);
+                }
+            }
+        }
+        shuffle(edges, rnd);
+
+        for (Index row = 0; row < rows; row++) {
+            for (Index col = 0; col < cols; col++) {
+                maze.set(2 * row + 1, 2 * col + 1);
+            }
+        }
+
+        DisjointSet<Index> sets(cells);
+        Index joined = 1;
+
+        constexpr std::size_t AHEAD = 16;
+        for (std::size_t i = 0; i < edges.size(); i++) {
+            if (i + AHEAD < edges.size()) {
+                sets.prefetch(edges[i + AHEAD] / 2);
+            }
+            Index cell = edges[i] / 2;
+            bool south = edges[i] % 2;
+            Index other = south ? cell + cols : cell + 1;
+
+            if (sets.join(cell, other)) {
+                int row = 2 * (cell / cols) + 1;
+                int col = 2 * (cell % cols) + 1;
+                maze.set(row + south, col + !south);
+
+                if (++joined == cells) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Disjoint set lookup with path halving.
+    int root(std::vector<int>& set, int cell) {
+        while (set[cell] != cell) {
+            set[cell] = set[set[cell]];
+            cell = set[cell];
+        }
+
+        return cell;
+    }
+
+    // A rectangle of odd cells.  The cell in row r and column c (counting
+    // from 0) is at row 2r + 1 and column 2c + 1 of the maze.
+    struct Region {
+        int row_;
+        int col_;
+        int rows_;
+        int cols_;
+    };
+
+    void backtrack(Maze& maze, std::mt19937& rnd, const Region& region) {
+        auto top = 2 * region.row_ + 1;
+        auto left = 2 * region.col_ + 1;
+        auto bottom = top + 2 * (region.rows_ - 1);
+        auto right = left + 2 * (region.cols_ - 1);
+
+        std::uniform_int_distribution<int> rows(0, region.rows_ - 1);
+        std::uniform_int_distribution<int> cols(0, region.cols_ - 1);
+
+        std::vector<Position> stack;
+        stack.push_back({ top + rows(rnd) * 2, left + cols(rnd) * 2 });
+        maze.set(stack.back().row_, stack.back().col_);
+
+        while (!stack.empty()) {
+            auto here = stack.back();
+            std::array<Position, 4> next;
+            int found = 0;
+
+            if (here.row_ > top && !maze.at(here.row_ - 2, here.col_)) {
+                next[found++] = Position{-1, 0};
+            }
+            if (here.row_ < bottom && !maze.at(here.row_ + 2, here.col_)) {
+                next[found++] = Position{1, 0};
+            }
+            if (here.col_ > left && !maze.at(here.row_, here.col_ - 2)) {
+                next[found++] = Position{0, -1};
+            }
+            if (here.col_ < right && !maze.at(here.row_, here.col_ + 2)) {
+                next[found++] = Position{0, 1};
+            }
+
+            if (found == 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            std::uniform_int_distribution<int> pick(0, found - 1);
+            auto dir = next[pick(rnd)];
+
+            maze.set(here.row_ + dir.row_, here.col_ + dir.col_);
+            stack.push_back({ here.row_ + dir.row_ * 2,
+                here.col_ + dir.col_ * 2 });
+            maze.set(stack.back().row_, stack.back().col_);
+        }
+    }
+}
+
+const char* name(GENERATOR generator) {
+    return generators[static_cast<int>(generator)].name_;
+}
+
+bool find(const std::string& name, GENERATOR& generator) {
+    for (const auto& g : generators) {
+        if (name == g.name_) {
+            generator = g.generator_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// All the generators expect to be given a maze which is all walls and leave
+// every cell with odd row and column numbers open and connected to every
+// other such cell by exactly one path.
+//
+// threads is only used by the tiled generator.  If it is 0, one thread per
+// processor is used.
+void generate(GENERATOR generator, Maze& maze, std::mt19937& rnd,
+unsigned threads) {
+    if (generator == GENERATOR::TILED) {
+        tiled(maze, rnd, threads);
+    } else {
+        generators[static_cast<int>(generator)].generate_(maze, rnd);
+    }
+}
+
+// Set the entrance on the top row.  it has to be above an empty cell on the
+// next row so pick one of those at random.
+Position chooseEntrance(const Maze& maze, std::mt19937& rnd) {
+    auto freeCols = maze.count(1, 1, maze.width() - 1);
+
+    std::uniform_int_distribution<int> col(0, freeCols - 1);
+
+    return {0, maze.nth(1, 1, maze.width() - 1, col(rnd)) };
+}
+
+// Set the exit on the bottom row.  it has to be below an empty cell on the
+// previous row.  Once again, pick one of those at random.
+Position chooseExit(const Maze& maze, std::mt19937& rnd) {
+    auto row = maze.height() - 2;
+    auto freeCols = maze.count(row, 1, maze.width() - 1);
+
+    std::uniform_int_distribution<int> col(0, freeCols - 1);
+
+    return {maze.height() - 1, maze.nth(row, 1, maze.width() - 1, col(rnd)) };
+}
+
+// Pick random cells until one which is already open is found and walk from it
+// until blocked.  This is the original algorithm; it gets slower and slower
+// as fewer closed cells are left to find.
+void carve(Maze& maze, std::mt19937& rnd) {
+    auto height = maze.height();
+    auto width = maze.width();
+
+    std::array<Position, 4> dirs {
+        Position{-1, 0}, // North
+        Position{1,  0}, // South
+        Position{0, -1}, // West
+        Position{0,  1}  // East
+    };
+
+    // Worked out in std::size_t as the product overflows int for big mazes.
+    auto cells = static_cast<std::size_t>(height - 1) * (width - 1) / 4;
+    std::size_t done = 0;
+
+    std::uniform_int_distribution<int> rows(1, (height / 2));
+    std::uniform_int_distribution<int> cols(1,  (width / 2));
+    std::uniform_int_distribution<int> direction(0, 4);
+
+    do {
+        // this code is used to make sure rows and columns are odd
+
+        int row = 1 + (rows(rnd) - 1) * 2;
+        int col = 1 + (cols(rnd) - 1) * 2;
+
+        if (done == 0) {
+            maze.set(row, col);
+        }
+
+        if(maze.at(row, col)) {
+
+            //Randomize Directions
+            std::shuffle(dirs.begin(), dirs.end(), rnd);
+
+            bool blocked = true;
+
+            do {
+                if (direction(rnd) == 0) {
+                    std::shuffle(dirs.begin(), dirs.end(), rnd);
+                }
+                blocked = true;
+                for (auto i = 0; i < 4; i++) {
+                    // Determine which direction the tile is
+                    auto r = row + dirs[i].row_ * 2;
+                    auto c = col + dirs[i].col_ * 2;
+                    //Check to see if the tile can be used
+                    if (r >= 1 && r < height - 1 && c >= 1 &&
+                    c < width - 1) {
+                        if (!maze.at(r, c)) {
+                            //create destination location
+                            maze.set(r, c);
+                            //create intermediate location
+                            maze.set(row + dirs[i].row_, col + dirs[i].col_);
+                            row = r;
+                            col = c;
+                            blocked = false;
+                            done++;
+                            break;
+                        }
+                    }
+                }
+                //recursive, no directions found, loop back a node
+            } while (!blocked);
+        }
+
+    } while (done + 1 < cells);
+}
+
+// Depth-first search from a random cell, backing up along the path taken so
+// far (kept on an explicit stack) whenever a dead end is reached.  Every cell
+// is visited once so this takes time proportional to the size of the maze.
+void backtrack(Maze& maze, std::mt19937& rnd) {
+    backtrack(maze, rnd, Region{0, 0, maze.height() / 2, maze.width() / 2});
+}
+
+void eller(Maze& maze, std::mt19937& rnd) {
+    eller(maze.height(), maze.width(), rnd,
+        [&maze](int row, const Maze::Word* words) {
+            std::copy(words, words + maze.stride(), maze.row(row));
+        });
+}
+
+// Eller's algorithm builds the maze one row at a time remembering only which
+// cells in the current row are connected to each other (in set) so a maze
+// of any height can be made in memory proportional to its width.  Each row
+// is passed to sink as soon as it is finished.
+void eller(int height, int width, std::mt19937& rnd, const RowSink& sink) {
+    auto stride = (width + Maze::BITS - 1) / Maze::BITS;
+    auto cells = width / 2;
+    auto rows = height / 2;
+    RandomBits random(rnd);
+
+    std::vector<Maze::Word> across(stride, 0);
+    std::vector<Maze::Word> down(stride, 0);
+    std::vector<int> set(cells);
+    std::vector<int> next(cells);
+    std::vector<int> last(cells);
+    std::vector<int> leader(cells);
+    std::vector<bool> hasDown(cells);
+
+    std::iota(set.begin(), set.end(), 0);
+    sink(0, down.data());
+
+    for (auto row = 0; row < rows; row++) {
+        auto lastRow = (row == rows - 1);
+
+        // Randomly join neighbouring cells which are not already connected.
+        // On the last row every one of them must be joined.
+        std::fill(across.begin(), across.end(), 0);
+        for (auto cell = 0; cell < cells; cell++) {
+            open(across, 2 * cell + 1);
+        }
+        for (auto cell = 0; cell + 1 < cells; cell++) {
+            auto left = root(set, cell);
+            auto right = root(set, cell + 1);
+
+            if (left != right && (lastRow || random(1))) {
+                open(across, 2 * cell + 2);
+                set[right] = left;
+            }
+        }
+        sink(2 * row + 1, across.data());
+
+        std::fill(down.begin(), down.end(), 0);
+        if (!lastRow) {
+            // Randomly open paths down to the next row making sure that
+            // every set gets at least one.
+            for (auto cell = 0; cell < cells; cell++) {
+                set[cell] = root(set, cell);
+                last[set[cell]] = cell;
+                hasDown[set[cell]] = false;
+            }
+            for (auto cell = 0; cell < cells; cell++) {
+                auto s = set[cell];
+                if (random(1) || (last[s] == cell && !hasDown[s])) {
+                    hasDown[s] = true;
+                    open(down, 2 * cell + 1);
+                }
+            }
+
+            // Cells with a path down stay in their set, now led by the first
+            // of them.  The rest start new sets of their own.
+            std::fill(leader.begin(), leader.end(), -1);
+            for (auto cell = 0; cell < cells; cell++) {
+                auto col = 2 * cell + 1;
+                if ((down[col / Maze::BITS] >> (col % Maze::BITS)) & 1) {
+                    if (leader[set[cell]] < 0) {
+                        leader[set[cell]] = cell;
+                    }
+                    next[cell] = leader[set[cell]];
+                } else {
+                    next[cell] = cell;
+                }
+            }
+            set.swap(next);
+        }
+        sink(2 * row + 2, down.data());
+    }
+}
+
+// Kruskal's algorithm knocks down walls in a random order unless the cells
+// on either side of them are already connected.
+void kruskal(Maze& maze, std::mt19937& rnd) {
+    auto edges = 2 * (static_cast<std::uint64_t>(maze.height() / 2) *
+        (maze.width() / 2));
+
+    if (edges <= INT32_MAX) {
+        joinCells<std::int32_t>(maze, rnd);
+    } else {
+        joinCells<std::int64_t>(maze, rnd);
+    }
+}
+
+// Wilson's algorithm adds each cell not yet in the maze by a random walk from
+// it until it reaches a cell which is.  Any loops in the walk are erased, by
+// remembering only the last direction taken out of each cell, so that the
+// maze is equally likely to be any of the possible ones.
+void wilson(Maze& maze, std::mt19937& rnd) {
+    auto rows = maze.height() / 2;
+    auto cols = maze.width() / 2;
+    RandomBits random(rnd);
+
+    // Indexed by GO.
+    const std::array<Position, 4> steps {
+        Position{0,  1},
+        Position{1,  0},
+        Position{0, -1},
+        Position{-1, 0}
+    };
+
+    // The direction of the walk out of each cell (which is not yet in the
+    // maze.)
+    std::vector<std::uint8_t> heading(static_cast<std::size_t>(rows) * cols);
+
+    std::uniform_int_distribution<int> startRow(0, rows - 1);
+    std::uniform_int_distribution<int> startCol(0, cols - 1);
+    maze.set(2 * startRow(rnd) + 1, 2 * startCol(rnd) + 1);
+
+    for (auto r = 0; r < rows; r++) {
+        for (auto c = 0; c < cols; c++) {
+            auto row = r;
+            auto col = c;
+
+            while (!maze.at(2 * row + 1, 2 * col + 1)) {
+                unsigned dir;
+                Position next;
+
+                do {
+                    dir = random(2);
+                    next = { row + steps[dir].row_, col + steps[dir].col_ };
+                } while (next.row_ < 0 || next.row_ >= rows || next.col_ < 0 ||
+                next.col_ >= cols);
+
+                heading[static_cast<std::size_t>(row) * cols + col] = dir;
+                row = next.row_;
+                col = next.col_;
+            }
+
+            row = r;
+            col = c;
+
+            while (!maze.at(2 * row + 1, 2 * col + 1)) {
+                const auto& step =
+                    steps[heading[static_cast<std::size_t>(row) * cols + col]];
+
+                maze.set(2 * row + 1, 2 * col + 1);
+                maze.set(2 * row + 1 + step.row_, 2 * col + 1 + step.col_);
+                row += step.row_;
+                col += step.col_;
+            }
+        }
+    }
+}
+
+void tiled(Maze& maze, std::mt19937& rnd) {
+    tiled(maze, rnd, 0);
+}
+
+// The maze is divided into square tiles of TILE x TILE cells and each tile is
+// made into a maze of its own by the backtracker.  The tiles are independent
+// so they are shared out between threads.  Then a random spanning tree of the
+// tiles is found (using Kruskal's algorithm) and for each pair of neighbouring
+// tiles in it, a random wall on the border between them is removed.
+//
+// Each tile gets its own random number generator seeded from one number drawn
+// from rnd and the position of the tile so the maze only depends on rnd and
+// not on the number of threads or what order the tiles are done in.  TILE is
+// a multiple of 32 so each tile covers whole words of the rows it is in and
+// threads never write to the same word.
+void tiled(Maze& maze, std::mt19937& rnd, unsigned threads) {
+    constexpr int TILE = 256;
+    static_assert(TILE % (Maze::BITS / 2) == 0, "tiles must be word aligned");
+
+    auto rows = maze.height() / 2;
+    auto cols = maze.width() / 2;
+    auto tileRows = (rows + TILE - 1) / TILE;
+    auto tileCols = (cols + TILE - 1) / TILE;
+    auto tiles = tileRows * tileCols;
+    std::uint32_t base = rnd();
+
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = std::min(threads, static_cast<unsigned>(tiles));
+
+    std::atomic<int> nextTile{0};
+    auto worker = [&]() {
+        for (auto tile = nextTile++; tile < tiles; tile = nextTile++) {
+            std::seed_seq seeds{ base, static_cast<std::uint32_t>(tile) };
+            std::mt19937 tileRnd(seeds);
+            Region region{ (tile / tileCols) * TILE, (tile % tileCols) * TILE,
+                0, 0 };
+            region.rows_ = std::min(TILE, rows - region.row_);
+            region.cols_ = std::min(TILE, cols - region.col_);
+
+            backtrack(maze, tileRnd, region);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = 1u; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // As in kruskal(), the border to the east of tile n is edge 2n and the
+    // border to the south of it is edge 2n + 1.
+    std::vector<int> edges;
+    for (auto tile = 0; tile < tiles; tile++) {
+        if (tile % tileCols != tileCols - 1) {
+            edges.push_back(2 * tile);
+        }
+        if (tile / tileCols != tileRows - 1) {
+            edges.push_back(2 * tile + 1);
+        }
+    }
+    shuffle(edges, rnd);
+
+    DisjointSet<int> sets(tiles);
+    for (auto edge : edges) {
+        auto tile = edge / 2;
+        bool south = edge % 2;
+        auto row = (tile / tileCols) * TILE;
+        auto col = (tile % tileCols) * TILE;
+
+        if (!sets.join(tile, south ? tile + tileCols : tile + 1)) {
+            continue;
+        }
+
+        if (south) {
+            auto span = std::min(TILE, cols - col);
+            auto door = col + static_cast<int>(below(span, rnd));
+            maze.set(2 * (row + TILE), 2 * door + 1);
+        } else {
+            auto span = std::min(TILE, rows - row);
+            auto door = row + static_cast<int>(below(span, rnd));
+            maze.set(2 * door + 1, 2 * (col + TILE));
+        }
+    }
+}
@@ -0,0 +1,265 @@
+// junctions -- a maze as a graph of its junctions
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "junctions.h"
+
+namespace {
+    constexpr int ROWS[] = { 0, 1, 0, -1 };
+    constexpr int COLS[] = { 1, 0, -1, 0 };
+
+    unsigned back(unsigned direction) {
+        return (direction + 2) % 4;
+    }
+}
+
+Junctions::Junctions() : width_{0}, entrance_{0, 0}, exit_{0, 0}, cells_(),
+offsets_(), targets_(), weights_(), directions_() {
+}
+
+// Finds the nodes of maze and then follows each corridor leading out of
+// them to the next node.  Every corridor is followed once from each end so
+// the graph has an edge each way.
+void Junctions::build(const Maze& maze, const Position& entrance,
+const Position& exit) {
+    width_ = maze.width();
+    entrance_ = entrance;
+    exit_ = exit;
+    cells_.clear();
+    offsets_.clear();
+    targets_.clear();
+    weights_.clear();
+    directions_.clear();
+
+    for (auto row = 0; row < maze.height(); row++) {
+        const auto* words = maze.row(row);
+        for (auto word = 0; word < maze.stride(); word++) {
+            for (auto bits = words[word]; bits; bits &= bits - 1) {
+                auto col = word * Maze::BITS + __builtin_ctzll(bits);
+                if (isNode(maze, row, col)) {
+                    cells_.push_back(row * width_ + col);
+                }
+            }
+        }
+    }
+
+    offsets_.push_back(0);
+    for (std::uint32_t n = 0; n < cells_.size(); n++) {
+        auto start = position(n);
+        auto exits = maze.exits(start.row_, start.col_);
+
+        for (auto d = 0u; d < 4; d++) {
+            if (!(exits & (1u << d))) {
+                continue;
+            }
+
+            auto here = start;
+            auto direction = d;
+            std::uint32_t length = 0;
+            do {
+                here.row_ += ROWS[direction];
+                here.col_ += COLS[direction];
+                length++;
+                if (isNode(maze, here.row_, here.col_)) {
+                    break;
+                }
+                direction = __builtin_ctz(maze.exits(here.row_, here.col_) &
+                    ~(1u << back(direction)));
+            } while (true);
+
+            targets_.push_back(node(here));
+            weights_.push_back(length);
+            directions_.push_back(d);
+        }
+        offsets_.push_back(targets_.size());
+    }
+}
+
+std::size_t Junctions::nodes() const {
+    return cells_.size();
+}
+
+std::size_t Junctions::edges() const {
+    return targets_.size();
+}
+
+// The node at position or NONE if it isn't one.
+std::uint32_t Junctions::node(const Position& position) const {
+    auto cell = position.row_ * width_ + position.col_;
+    auto found = std::lower_bound(cells_.begin(), cells_.end(), cell);
+
+    return (found != cells_.end() && *found == cell) ?
+        found - cells_.begin() : NONE;
+}
+
+Position Junctions::position(std::uint32_t node) const {
+    return { static_cast<int>(cells_[node] / width_),
+        static_cast<int>(cells_[node] % width_) };
+}
+
+// Finds the shortest way from from to to.  Returns its length (or NONE if
+// there isn't one) and puts the edges along it in path.  settled is set to
+// the number of nodes whose distance was worked out on the way.
+std::uint32_t Junctions::dijkstra(std::uint32_t from, std::uint32_t to,
+std::vector<std::uint32_t>& path, std::size_t& settled) const {
+    using Entry = std::pair<std::uint32_t, std::uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<std::uint32_t> distance(nodes(), NONE);
+    std::vector<std::uint32_t> parent(nodes(), NONE);
+
+    path.clear();
+    settled = 0;
+    distance[from] = 0;
+    queue.emplace(0, from);
+
+    while (!queue.empty()) {
+        auto [d, n] = queue.top();
+        queue.pop();
+        if (d != distance[n]) {
+            continue;
+        }
+        settled++;
+
+        if (n == to) {
+            for (auto e = parent[to]; e != NONE; e = parent[n]) {
+                path.push_back(e);
+                n = std::upper_bound(offsets_.begin(), offsets_.end(), e) -
+                    offsets_.begin() - 1;
+            }
+            std::reverse(path.begin(), path.end());
+            return d;
+        }
+
+        for (auto e = offsets_[n]; e < offsets_[n + 1]; e++) {
+            auto next = d + weights_[e];
+            if (next < distance[targets_[e]]) {
+                distance[targets_[e]] = next;
+                parent[targets_[e]] = e;
+                queue.emplace(next, targets_[e]);
+            }
+        }
+    }
+
+    return NONE;
+}
+
+// Tremaux's algorithm, which is how a person with a piece of chalk would
+// explore the maze.  Each corridor is marked when it is walked down.  On
+// reaching a junction already visited, turn back.  At a junction with no
+// unmarked corridors left, go back down the corridor which led to it.  The
+// corridors from from to to end up marked once and are put in path.  Returns
+// the length of that path (or NONE if there isn't one) and sets walked to the
+// distance walked in total to find it.
+std::uint32_t Junctions::tremaux(std::uint32_t from, std::uint32_t to,
+std::vector<std::uint32_t>& path, std::size_t& walked) const {
+    std::vector<bool> visited(nodes(), false);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+    std::uint32_t length = 0;
+
+    path.clear();
+    walked = 0;
+    visited[from] = true;
+    stack.emplace_back(from, offsets_[from]);
+
+    while (!stack.empty()) {
+        auto& [n, e] = stack.back();
+
+        if (n == to) {
+            return length;
+        }
+
+        if (e == offsets_[n + 1]) {
+            stack.pop_back();
+            if (!path.empty()) {
+                walked += weights_[path.back()];
+                length -= weights_[path.back()];
+                path.pop_back();
+            }
+            continue;
+        }
+
+        auto edge = e++;
+        auto next = targets_[edge];
+        if (!visited[next]) {
+            visited[next] = true;
+            walked += weights_[edge];
+            length += weights_[edge];
+            path.push_back(edge);
+            stack.emplace_back(next, offsets_[next]);
+        } else if (stack.size() < 2 || next != stack[stack.size() - 2].first) {
+            walked += 2 * weights_[edge];
+        }
+    }
+
+    return NONE;
+}
+
+// The length of the shortest path between every pair of nodes, with the one
+// from node i to node j at distances[i * nodes() + j].  This needs nodes()
+// squared entries so it is only practical for small mazes.
+void Junctions::allPairs(std::vector<std::uint32_t>& distances) const {
+    using Entry = std::pair<std::uint32_t, std::uint32_t>;
+    auto count = nodes();
+
+    distances.assign(count * count, NONE);
+    for (std::uint32_t from = 0; from < count; from++) {
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>
+            queue;
+        auto* distance = &distances[from * count];
+
+        distance[from] = 0;
+        queue.emplace(0, from);
+        while (!queue.empty()) {
+            auto [d, n] = queue.top();
+            queue.pop();
+            if (d != distance[n]) {
+                continue;
+            }
+
+            for (auto e = offsets_[n]; e < offsets_[n + 1]; e++) {
+                auto next = d + weights_[e];
+                if (next < distance[targets_[e]]) {
+                    distance[targets_[e]] = next;
+                    queue.emplace(next, targets_[e]);
+                }
+            }
+        }
+    }
+}
+
+// Turns a path of edges starting at node from back into the cells along it
+// by walking down each corridor again.
+void Junctions::expand(const Maze& maze, std::uint32_t from,
+const std::vector<std::uint32_t>& edges, std::vector<Position>& path) const {
+    auto here = position(from);
+
+    path.clear();
+    path.push_back(here);
+    for (auto e : edges) {
+        unsigned direction = directions_[e];
+
+        for (auto step = 0u; step < weights_[e]; step++) {
+            if (step) {
+                direction = __builtin_ctz(maze.exits(here.row_, here.col_) &
+                    ~(1u << back(direction)));
+            }
+            here.row_ += ROWS[direction];
+            here.col_ += COLS[direction];
+            path.push_back(here);
+        }
+    }
+}
+
+// A cell is a node unless it has exactly two ways out.  The entrance and exit
+// are always nodes.
+bool Junctions::isNode(const Maze& maze, int row, int col) const {
+    return __builtin_popcount(maze.exits(row, col)) != 2 ||
+        (row == entrance_.row_ && col == entrance_.col_) ||
+        (row == exit_.row_ && col == exit_.col_);
+}
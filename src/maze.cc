@@ -0,0 +1,123 @@
+// maze -- maze grid
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include "maze.h"
+
+Maze::Maze(int height, int width) : height_{height}, width_{width},
+stride_{(width + BITS - 1) / BITS},
+words_(static_cast<std::size_t>(height) * stride_, 0),
+cells_{words_.data()} {
+}
+
+Maze::Maze(int height, int width, Word* cells) : height_{height},
+width_{width}, stride_{(width + BITS - 1) / BITS}, words_{},
+cells_{cells} {
+}
+
+Maze::Maze(const Maze& other) : height_{other.height_}, width_{other.width_},
+stride_{other.stride_},
+words_(other.cells_, other.cells_ + other.bytes() / sizeof(Word)),
+cells_{words_.data()} {
+}
+
+Maze::Maze(Maze&& other) noexcept : height_{other.height_},
+width_{other.width_}, stride_{other.stride_},
+words_{std::move(other.words_)}, cells_{other.cells_} {
+    other.cells_ = nullptr;
+}
+
+Maze& Maze::operator=(const Maze& other) {
+    if (this != &other) {
+        *this = Maze(other);
+    }
+
+    return *this;
+}
+
+Maze& Maze::operator=(Maze&& other) noexcept {
+    if (this != &other) {
+        height_ = other.height_;
+        width_ = other.width_;
+        stride_ = other.stride_;
+        words_ = std::move(other.words_);
+        cells_ = other.cells_;
+        other.cells_ = nullptr;
+    }
+
+    return *this;
+}
+
+// Returns the given word of row shifted so that bit c is set if the
+// neighbour of cell c in direction is open.  Cells beyond the edges of the
+// maze count as walls.
+Maze::Word Maze::open(int row, int word, GO direction) const {
+    const auto* here = cells_ + static_cast<std::size_t>(row) * stride_;
+
+    switch (direction) {
+        case GO::EAST: {
+            Word next = (word + 1 < stride_) ? here[word + 1] : 0;
+            return (here[word] >> 1) | (next << (BITS - 1));
+        }
+        case GO::SOUTH:
+            return (row + 1 < height_) ? here[word + stride_] : 0;
+        case GO::WEST: {
+            Word prev = (word > 0) ? here[word - 1] : 0;
+            return (here[word] << 1) | (prev >> (BITS - 1));
+        }
+        case GO::NORTH:
+            return (row > 0) ? here[word - stride_] : 0;
+    }
+
+    return 0;
+}
+
+// The number of open cells in row between columns first and last - 1.
+int Maze::count(int row, int first, int last) const {
+    const auto* here = cells_ + static_cast<std::size_t>(row) * stride_;
+    int result = 0;
+
+    for (auto word = first / BITS; word * BITS < last; word++) {
+        result += __builtin_popcountll(here[word] & mask(first, last, word));
+    }
+
+    return result;
+}
+
+// The column of the nth (counting from 0) open cell in row between columns
+// first and last - 1 or -1 if there are not that many.
+int Maze::nth(int row, int first, int last, int n) const {
+    const auto* here = cells_ + static_cast<std::size_t>(row) * stride_;
+
+    for (auto word = first / BITS; word * BITS < last; word++) {
+        auto bits = here[word] & mask(first, last, word);
+        auto found = __builtin_popcountll(bits);
+
+        if (n < found) {
+            for (; n > 0; n--) {
+                bits &= bits - 1;
+            }
+            return word * BITS + __builtin_ctzll(bits);
+        }
+        n -= found;
+    }
+
+    return -1;
+}
+
+// The bits of word which lie between columns first and last - 1.
+Maze::Word Maze::mask(int first, int last, int word) const {
+    auto low = std::max(first - word * BITS, 0);
+    auto high = std::min(last - word * BITS, BITS);
+
+    if (low >= high) {
+        return 0;
+    }
+
+    auto bits = (high - low == BITS) ? ~Word{0} : (Word{1} << (high - low)) - 1;
+
+    return bits << low;
+}
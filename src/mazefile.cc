@@ -0,0 +1,195 @@
+// mazefile -- save and load mazes
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mazefile.h"
+
+namespace {
+    constexpr char MAGIC[8] = { 'T', 'E', 'S', 'T', 'M', 'A', 'Z', 'E' };
+    constexpr std::uint32_t VERSION = 1;
+
+    // Is (row, col) a cell on the edge of a maze which is height x width?
+    bool border(std::int32_t row, std::int32_t col, std::int32_t height,
+    std::int32_t width) {
+        if (row < 0 || row >= height || col < 0 || col >= width) {
+            return false;
+        }
+
+        return row == 0 || row == height - 1 || col == 0 || col == width - 1;
+    }
+
+    // Is there a valid maze at offset in the mapped file which is size bytes
+    // long?
+    bool valid(const char* map, std::size_t size, std::size_t offset) {
+        if (size < sizeof(MazeHeader) || offset > size - sizeof(MazeHeader)) {
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const MazeHeader*>(map + offset);
+        if (std::memcmp(header->magic_, MAGIC, sizeof(MAGIC)) != 0 ||
+        header->version_ != VERSION ||
+        header->generator_ >= static_cast<std::uint32_t>(GENERATORS) ||
+        header->height_ < 3 || header->width_ < 3 ||
+        !border(header->entranceRow_, header->entranceCol_, header->height_,
+            header->width_) ||
+        !border(header->exitRow_, header->exitCol_, header->height_,
+            header->width_)) {
+            return false;
+        }
+
+        // The width comes from the file so it could be anything.  Maze works
+        // out its stride in int and its size in std::size_t so both of those
+        // have to be big enough.
+        auto stride = (static_cast<std::uint64_t>(header->width_) +
+            Maze::BITS - 1) / Maze::BITS;
+        auto words = static_cast<std::uint64_t>(header->height_) * stride;
+        if (header->width_ > INT32_MAX - (Maze::BITS - 1) ||
+        words > SIZE_MAX / sizeof(Maze::Word)) {
+            return false;
+        }
+
+        auto bytes = words * sizeof(Maze::Word);
+
+        return header->bytes_ == bytes &&
+            bytes <= size - offset - sizeof(MazeHeader);
+    }
+}
+
+MazeHeader makeHeader(const Maze& maze, unsigned seed, GENERATOR generator,
+const Position& entrance, const Position& exit) {
+    MazeHeader header{};
+
+    std::copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic_);
+    header.version_ = VERSION;
+    header.generator_ = static_cast<std::uint32_t>(generator);
+    header.seed_ = seed;
+    header.height_ = maze.height();
+    header.width_ = maze.width();
+    header.entranceRow_ = entrance.row_;
+    header.entranceCol_ = entrance.col_;
+    header.exitRow_ = exit.row_;
+    header.exitCol_ = exit.col_;
+    header.bytes_ = maze.bytes();
+
+    return header;
+}
+
+// Writes the maze at offset in the file fd.
+bool save(int fd, off_t offset, const MazeHeader& header, const Maze& maze) {
+    return writeAt(fd, offset, &header, sizeof(header)) &&
+        writeAt(fd, offset + sizeof(header), maze.row(0), maze.bytes());
+}
+
+// Copies the header and maze into buffer which must have room for
+// sizeof(header) + maze.bytes() bytes.  Returns the end of what was copied.
+char* serialize(char* buffer, const MazeHeader& header, const Maze& maze) {
+    const auto* cells = reinterpret_cast<const char*>(maze.row(0));
+
+    buffer = std::copy_n(reinterpret_cast<const char*>(&header),
+        sizeof(header), buffer);
+    return std::copy_n(cells, maze.bytes(), buffer);
+}
+
+// Like pwrite() but keeps going until everything has been written.  As it
+// does not use the file position, several threads can write to different
+// parts of the same file at once.
+bool writeAt(int fd, off_t offset, const void* data, std::size_t size) {
+    const auto* p = static_cast<const char*>(data);
+
+    while (size) {
+        auto written = pwrite(fd, p, size, offset);
+        if (written < 0) {
+            return false;
+        }
+        p += written;
+        offset += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+MazeFile::MazeFile() : map_{MAP_FAILED}, size_{0}, header_{nullptr} {
+}
+
+MazeFile::~MazeFile() {
+    close();
+}
+
+// Maps the file at path into memory and finds the maze at position index
+// (counting from 0) in it.  Returns false if the file cannot be read or there
+// is no valid maze at that position.
+bool MazeFile::open(const std::string& path, unsigned long index) {
+    close();
+
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // A private mapping lets Model change cells (but not the file.)  The
+    // mapping stays valid after the file is closed.
+    size_ = st.st_size;
+    map_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_NORESERVE, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* map = static_cast<char*>(map_);
+    std::size_t offset = 0;
+
+    for (;;) {
+        if (!valid(map, size_, offset)) {
+            close();
+            return false;
+        }
+
+        if (index-- == 0) {
+            break;
+        }
+
+        const auto* header = reinterpret_cast<const MazeHeader*>(map + offset);
+        offset += sizeof(MazeHeader) + header->bytes_;
+    }
+
+    header_ = reinterpret_cast<MazeHeader*>(static_cast<char*>(map_) + offset);
+
+    return true;
+}
+
+const MazeHeader& MazeFile::header() const {
+    return *header_;
+}
+
+// A view of the cells of the maze in the file.  It is only valid while this
+// MazeFile is open.
+Maze MazeFile::maze() const {
+    return Maze(header_->height_, header_->width_,
+        reinterpret_cast<Maze::Word*>(header_ + 1));
+}
+
+void MazeFile::close() {
+    if (map_ != MAP_FAILED) {
+        munmap(map_, size_);
+        map_ = MAP_FAILED;
+    }
+    size_ = 0;
+    header_ = nullptr;
+}
@@ -0,0 +1,168 @@
+// model -- maze demo state
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <utility>
+#include "model.h"
+
+Model::Model(unsigned seed, int height, int width, GENERATOR generator,
+unsigned threads) : seed_{seed}, generator_{generator}, rnd_{seed_},
+maze_{makeMaze(height, width, threads)},
+entrance_{makeEntrance()}, exit_{makeExit()}, player_{entrance_}, tick_{0},
+direction_{GO::SOUTH}, solver_{SOLVER::FOLLOWER}, solution_{{}, 0}, step_{0},
+agents_{} {
+    maze_.set(entrance_.row_, entrance_.col_);
+    maze_.set(exit_.row_, exit_.col_);
+}
+
+// A model of a maze which has already been made (for example loaded from a
+// file.)
+Model::Model(unsigned seed, GENERATOR generator, Maze maze,
+const Position& entrance, const Position& exit) : seed_{seed},
+generator_{generator}, rnd_{seed_}, maze_{std::move(maze)},
+entrance_{entrance}, exit_{exit}, player_{entrance_}, tick_{0},
+direction_{GO::SOUTH}, solver_{SOLVER::FOLLOWER}, solution_{{}, 0}, step_{0},
+agents_{} {
+}
+
+// Fills in the dead ends of the maze so only the way from the entrance to the
+// exit is left.  Returns the number of cells filled.
+std::size_t Model::fillDeadEnds(Workspace& workspace) {
+    return ::fillDeadEnds(maze_, entrance_, exit_, workspace);
+}
+
+// Finds a path from the entrance to the exit with solver.  From then on
+// update() follows that path instead of the wall.  The wall follower doesn't
+// plan ahead so choosing it just goes back to following the wall.
+bool Model::solve(SOLVER solver, Workspace& workspace) {
+    solver_ = solver;
+    step_ = 0;
+
+    if (solver_ == SOLVER::FOLLOWER) {
+        solution_.path_.clear();
+        solution_.expanded_ = 0;
+        return true;
+    }
+
+    return ::solve(solver_, maze_, entrance_, exit_, workspace, solution_);
+}
+
+bool Model::finished() const {
+    return player_.row_ == exit_.row_ && player_.col_ == exit_.col_;
+}
+
+// Moves the player until they reach the exit and returns how many steps that
+// took.  A player following the wall visits each cell at most four times so
+// if they have taken more steps than that they are never going to get there
+// and 0 is returned.
+std::size_t Model::run() {
+    std::size_t limit = 4 * static_cast<std::size_t>(maze_.height()) *
+        maze_.width();
+    std::size_t steps = 0;
+
+    while (!finished()) {
+        if (steps == limit) {
+            return 0;
+        }
+        update();
+        steps++;
+    }
+
+    return steps;
+}
+
+// As above but also counts how many of the steps were into a cell the player
+// had already been in.
+std::size_t Model::run(std::size_t& revisits) {
+    std::size_t limit = 4 * static_cast<std::size_t>(maze_.height()) *
+        maze_.width();
+    std::size_t steps = 0;
+    Maze visited(maze_.height(), maze_.width());
+
+    revisits = 0;
+    visited.set(player_.row_, player_.col_);
+    while (!finished()) {
+        if (steps == limit) {
+            return 0;
+        }
+        update();
+        steps++;
+
+        if (visited.at(player_.row_, player_.col_)) {
+            revisits++;
+        } else {
+            visited.set(player_.row_, player_.col_);
+        }
+    }
+
+    return steps;
+}
+
+void Model::update() {
+    if (finished()) {
+        return;
+    }
+
+    if (solver_ != SOLVER::FOLLOWER) {
+        follow();
+        return;
+    }
+
+    switch (direction_) {
+        case GO::NORTH:
+            player_.row_--;
+            break;
+        case GO::EAST:
+            player_.col_++;
+            break;
+        case GO::SOUTH:
+            player_.row_++;
+            break;
+        case GO::WEST:
+            player_.col_--;
+            break;
+    }
+
+    const auto& turn = TURNS[static_cast<int>(direction_)]
+        [maze_.exits(player_.row_, player_.col_)];
+    direction_ = turn.direction_;
+    player_.row_ -= turn.jump_;
+}
+
+// Takes the next step along the path found by solve().
+void Model::follow() {
+    if (step_ + 1 >= solution_.path_.size()) {
+        return;
+    }
+
+    const auto& next = solution_.path_[++step_];
+
+    if (next.row_ < player_.row_) {
+        direction_ = GO::NORTH;
+    } else if (next.row_ > player_.row_) {
+        direction_ = GO::SOUTH;
+    } else if (next.col_ < player_.col_) {
+        direction_ = GO::WEST;
+    } else {
+        direction_ = GO::EAST;
+    }
+    player_ = next;
+}
+
+Maze Model::makeMaze(int height, int width, unsigned threads) {
+    Maze maze(height, width);
+
+    generate(generator_, maze, rnd_, threads);
+
+    return maze;
+}
+
+Position Model::makeEntrance() {
+    return chooseEntrance(maze_, rnd_);
+}
+
+Position Model::makeExit() {
+    return chooseExit(maze_, rnd_);
+}
@@ -0,0 +1,49 @@
+// pbm -- write mazes as portable bitmap images
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <array>
+#include "pbm.h"
+
+namespace {
+    // PBM puts the leftmost pixel in the most significant bit of each byte
+    // while Maze puts the leftmost cell in the least significant bit.
+    const std::array<unsigned char, 256> reversed = [] {
+        std::array<unsigned char, 256> table{};
+        for (auto i = 0; i < 256; i++) {
+            for (auto bit = 0; bit < 8; bit++) {
+                if (i & (1 << bit)) {
+                    table[i] |= 0x80 >> bit;
+                }
+            }
+        }
+        return table;
+    }();
+}
+
+PBM::PBM(std::ostream& out, int height, int width) : out_{out},
+width_{width}, buffer_((width + 7) / 8) {
+    out_ << "P4\n" << width << ' ' << height << '\n';
+}
+
+void PBM::row(const Maze::Word* words) {
+    for (std::size_t i = 0; i < buffer_.size(); i++) {
+        auto byte = (words[i / 8] >> (8 * (i % 8))) & 0xFF;
+        buffer_[i] = static_cast<char>(reversed[byte ^ 0xFF]);
+    }
+
+    // Pixels past the end of the row are padding and should be 0.
+    if (width_ % 8) {
+        buffer_.back() &= static_cast<char>(0xFF << (8 - width_ % 8));
+    }
+
+    out_.write(buffer_.data(), buffer_.size());
+}
+
+void PBM::write(const Maze& maze) {
+    for (auto r = 0; r < maze.height(); r++) {
+        row(maze.row(r));
+    }
+}
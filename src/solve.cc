@@ -0,0 +1,1017 @@
+// solve -- maze solving algorithms
+// By Jaldhar H. Vyas <jaldhar@braincells.com>
+//
+// Copyright (C) 2020, Consolidated Braincells Inc.
+// "Do what thou wilt" shall be the whole of the license.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include "solve.h"
+
+namespace {
+    struct Solver {
+        SOLVER solver_;
+        const char* name_;
+        bool (*solve_)(const Maze&, const Position&, const Position&,
+            Workspace&, Solution&);
+    };
+
+    const std::array<Solver, SOLVERS> solvers {
+        Solver{SOLVER::FOLLOWER, "follower", nullptr},
+        Solver{SOLVER::BFS, "bfs", bfs},
+        Solver{SOLVER::ASTAR, "astar", astar},
+        Solver{SOLVER::BIDIRECTIONAL, "bidirectional", bidirectional},
+        Solver{SOLVER::DISTANCE, "distance", descend},
+        Solver{SOLVER::JUNCTIONS, "junctions", junctions},
+        Solver{SOLVER::TREMAUX, "tremaux", tremaux},
+        Solver{SOLVER::DIJKSTRA, "dijkstra", dijkstra}
+    };
+
+    // Makes seen an empty maze the same size as maze, only allocating memory
+    // if the size has changed.
+    void fit(Maze& seen, const Maze& maze) {
+        if (seen.height() != maze.height() || seen.width() != maze.width()) {
+            seen = Maze(maze.height(), maze.width());
+        } else {
+            seen.clear();
+        }
+    }
+
+    // How far apart the numbers of two neighbouring cells are.
+    std::ptrdiff_t offset(GO direction, std::ptrdiff_t width) {
+        switch (direction) {
+            case GO::EAST:
+                return 1;
+            case GO::SOUTH:
+                return width;
+            case GO::WEST:
+                return -1;
+            case GO::NORTH:
+                return -width;
+        }
+
+        return 0;
+    }
+
+    Position position(std::size_t cell, std::size_t width) {
+        return { static_cast<int>(cell / width), static_cast<int>(cell % width) };
+    }
+
+    // Adds the cells from cell back to the one where the search started to
+    // path, following the direction each cell was entered from in parent.
+    void trace(std::size_t width, std::size_t cell, std::size_t from,
+    const Directions& parent, std::vector<Position>& path) {
+        path.push_back(position(cell, width));
+        while (cell != from) {
+            cell -= offset(parent.get(cell), width);
+            path.push_back(position(cell, width));
+        }
+    }
+
+    // A* search for heuristics which don't change by exactly 1 with every
+    // step.  The queue is a binary heap ordered by the estimated length of a
+    // path through each cell (f) and then by the number of steps taken to
+    // get to it (g), packed together into one number.  As in astar(), each
+    // entry is a cell number times 4 plus the direction it was entered from
+    // and only the first time a cell comes out counts.
+    bool astarHeap(const Maze& maze, const Position& from, const Position& to,
+    Workspace& workspace, Solution& solution, const Heuristic& heuristic) {
+        std::size_t width = maze.width();
+        auto& seen = workspace.seen_;
+        auto& parent = workspace.parent_;
+        auto& open = workspace.open_;
+        auto start = from.row_ * width + from.col_;
+        auto target = to.row_ * width + to.col_;
+        auto later = std::greater<>();
+
+        workspace.reset(maze);
+        solution.path_.clear();
+        solution.expanded_ = 0;
+
+        open.emplace_back(
+            static_cast<std::uint64_t>(heuristic.estimate_(from, to)) << 32,
+            start * 4);
+
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), later);
+            auto [key, entry] = open.back();
+            open.pop_back();
+
+            auto cell = entry / 4;
+            auto here = position(cell, width);
+            if (seen.at(here.row_, here.col_)) {
+                continue;
+            }
+            seen.set(here.row_, here.col_);
+            if (cell != start) {
+                parent.set(cell, static_cast<GO>(entry % 4));
+            }
+            solution.expanded_++;
+
+            if (cell == target) {
+                trace(width, cell, start, parent, solution.path_);
+                std::reverse(solution.path_.begin(), solution.path_.end());
+                return true;
+            }
+
+            auto exits = maze.exits(here.row_, here.col_);
+            auto steps = (key & 0xFFFFFFFF) + 1;
+
+            for (auto d = 0; d < 4; d++) {
+                auto direction = static_cast<GO>(d);
+                if (!(exits & bit(direction))) {
+                    continue;
+                }
+
+                auto next = cell + offset(direction, width);
+                auto there = position(next, width);
+                if (seen.at(there.row_, there.col_)) {
+                    continue;
+                }
+
+                auto estimate = steps + heuristic.estimate_(there, to);
+                open.emplace_back((estimate << 32) | steps, next * 4 + d);
+                std::push_heap(open.begin(), open.end(), later);
+            }
+        }
+
+        return false;
+    }
+
+    // Takes one level of cells (all the same distance from where the search
+    // started) from frontier and adds their unseen neighbours.  If one of
+    // those has already been seen by the search from the other end, returns
+    // true and sets meet to it.
+    bool expand(const Maze& maze, Frontier& frontier, Maze& seen,
+    Directions& parent, const Maze& other, std::size_t& expanded,
+    std::size_t& meet) {
+        std::size_t width = maze.width();
+
+        for (auto n = frontier.size(); n > 0; n--) {
+            auto cell = frontier.pop();
+            auto here = position(cell, width);
+            auto exits = maze.exits(here.row_, here.col_);
+            expanded++;
+
+            for (auto d = 0; d < 4; d++) {
+                auto direction = static_cast<GO>(d);
+                if (!(exits & bit(direction))) {
+                    continue;
+                }
+
+                auto next = cell + offset(direction, width);
+                auto there = position(next, width);
+                if (seen.at(there.row_, there.col_)) {
+                    continue;
+                }
+
+                seen.set(there.row_, there.col_);
+                parent.set(next, direction);
+                if (other.at(there.row_, there.col_)) {
+                    meet = next;
+                    return true;
+                }
+                frontier.push(next);
+            }
+        }
+
+        return false;
+    }
+}
+
+Frontier::Frontier(std::size_t capacity) : cells_(), mask_{0}, head_{0},
+tail_{0} {
+    std::size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    cells_.resize(size);
+    mask_ = size - 1;
+}
+
+void Frontier::clear() {
+    head_ = tail_ = 0;
+}
+
+bool Frontier::empty() const {
+    return head_ == tail_;
+}
+
+std::size_t Frontier::size() const {
+    return tail_ - head_;
+}
+
+void Frontier::push(std::size_t cell) {
+    if (size() == cells_.size()) {
+        grow();
+    }
+    cells_[tail_++ & mask_] = cell;
+}
+
+std::size_t Frontier::pop() {
+    return cells_[head_++ & mask_];
+}
+
+// Doubles the size of the buffer, moving the queue to the start of it.
+void Frontier::grow() {
+    std::vector<std::size_t> cells(cells_.size() * 2);
+
+    for (std::size_t i = 0; head_ + i != tail_; i++) {
+        cells[i] = cells_[(head_ + i) & mask_];
+    }
+    tail_ -= head_;
+    head_ = 0;
+    cells_.swap(cells);
+    mask_ = cells_.size() - 1;
+}
+
+Directions::Directions() : words_() {
+}
+
+// Make room for cells directions, all set to EAST.
+void Directions::reset(std::size_t cells) {
+    words_.assign((cells + 31) / 32, 0);
+}
+
+GO Directions::get(std::size_t cell) const {
+    return static_cast<GO>((words_[cell / 32] >> (2 * (cell % 32))) & 3);
+}
+
+void Directions::set(std::size_t cell, GO direction) {
+    auto shift = 2 * (cell % 32);
+    auto& word = words_[cell / 32];
+
+    word = (word & ~(std::uint64_t{3} << shift)) |
+        (static_cast<std::uint64_t>(direction) << shift);
+}
+
+std::size_t Directions::bytes() const {
+    return words_.size() * sizeof(std::uint64_t);
+}
+
+Distances::Distances() : width_{0}, near_(), far_(), sources_(), lost_(),
+affected_(), seeds_(), queue_() {
+}
+
+// Finds the distance of every cell in maze from the nearest of sources with
+// a breadth-first search starting from all of them at once.  Walls and cells
+// which can't be reached from any of sources are UNREACHABLE.  Returns the
+// number of cells which can be reached.
+std::size_t Distances::build(const Maze& maze,
+const std::vector<Position>& sources, Frontier& frontier) {
+    std::size_t width = maze.width();
+    auto cells = static_cast<std::size_t>(maze.height()) * width;
+    std::size_t reached = 0;
+
+    width_ = maze.width();
+    if (cells < FAR) {
+        near_.assign(cells, FAR);
+        far_.clear();
+    } else {
+        near_.clear();
+        far_.assign(cells, UNREACHABLE);
+    }
+
+    frontier.clear();
+    sources_.clear();
+    for (const auto& source : sources) {
+        auto cell = source.row_ * width + source.col_;
+        sources_.push_back(cell);
+        if (maze.at(source.row_, source.col_) && get(cell) == UNREACHABLE) {
+            set(cell, 0);
+            frontier.push(cell);
+        }
+    }
+
+    while (!frontier.empty()) {
+        auto cell = frontier.pop();
+        auto here = position(cell, width);
+        auto exits = maze.exits(here.row_, here.col_);
+        auto distance = get(cell) + 1;
+        reached++;
+
+        for (auto d = 0; d < 4; d++) {
+            auto direction = static_cast<GO>(d);
+            if (!(exits & bit(direction))) {
+                continue;
+            }
+
+            auto next = cell + offset(direction, width);
+            if (get(next) == UNREACHABLE) {
+                set(next, distance);
+                frontier.push(next);
+            }
+        }
+    }
+
+    return reached;
+}
+
+// Makes the changes in edits to maze and then fixes the distances without
+// starting again from scratch.  Returns the number of cells whose distance
+// was looked at again.
+//
+// First, walls which have been put up can make cells further away.  A cell
+// keeps its distance as long as it has a neighbour one step closer (or is a
+// source.)  Starting from the new walls, cells which have lost all their
+// neighbours that are one step closer lose their distance too and so on.
+//
+// Then those cells and any which have been opened get the distance of their
+// nearest neighbour plus one and the changes spread out from them (closest
+// first, as they might not all start out the same) for as long as they make
+// cells closer.  Opening a cell can make a shortcut for a large part of the
+// maze so this can go quite far.  Once more than 1 / REBUILD of the cells have
+// been looked at it is quicker to give up and start again from scratch with
+// build() (using frontier.)
+std::size_t Distances::apply(Maze& maze, const std::vector<Edit>& edits,
+Frontier& frontier) {
+    std::size_t width = width_;
+    std::size_t count = 0;
+    auto limit = (near_.size() + far_.size()) / REBUILD;
+
+    lost_.clear();
+    affected_.clear();
+    for (const auto& edit : edits) {
+        auto cell = edit.cell_.row_ * width + edit.cell_.col_;
+        maze.set(edit.cell_.row_, edit.cell_.col_, edit.open_);
+        affected_.push_back(cell);
+
+        auto distance = get(cell);
+        if (!edit.open_ && distance != UNREACHABLE) {
+            set(cell, UNREACHABLE);
+            lost_.emplace_back(cell, distance);
+        }
+    }
+
+    while (!lost_.empty()) {
+        auto [cell, distance] = lost_.back();
+        auto here = position(cell, width);
+        auto exits = maze.exits(here.row_, here.col_);
+        lost_.pop_back();
+        if (++count > limit) {
+            return count + rebuild(maze, frontier);
+        }
+
+        for (auto d = 0; d < 4; d++) {
+            auto direction = static_cast<GO>(d);
+            if (!(exits & bit(direction))) {
+                continue;
+            }
+
+            auto next = cell + offset(direction, width);
+            auto nextDistance = get(next);
+            if (nextDistance != distance + 1 || source(next)) {
+                continue;
+            }
+            if (nearest(maze, next) != nextDistance) {
+                set(next, UNREACHABLE);
+                lost_.emplace_back(next, nextDistance);
+                affected_.push_back(next);
+            }
+        }
+    }
+
+    seeds_.clear();
+    for (auto cell : affected_) {
+        auto here = position(cell, width);
+        if (!maze.at(here.row_, here.col_)) {
+            continue;
+        }
+
+        auto distance = source(cell) ? 0 : nearest(maze, cell);
+        if (distance < get(cell)) {
+            set(cell, distance);
+            seeds_.emplace_back(distance, cell);
+        }
+    }
+    std::sort(seeds_.begin(), seeds_.end());
+
+    // Every step adds one to the distance so cells are added to queue_ in
+    // order.  Merging it with the sorted seeds visits cells closest first like
+    // a priority queue would but as cheaply as a breadth-first search.
+    queue_.clear();
+    std::size_t seed = 0;
+    std::size_t head = 0;
+    while (seed < seeds_.size() || head < queue_.size()) {
+        std::pair<std::uint32_t, std::size_t> current;
+        if (head == queue_.size() ||
+        (seed < seeds_.size() && seeds_[seed] < queue_[head])) {
+            current = seeds_[seed++];
+        } else {
+            current = queue_[head++];
+        }
+
+        auto [distance, cell] = current;
+        if (++count > limit) {
+            return count + rebuild(maze, frontier);
+        }
+        if (distance != get(cell)) {
+            continue;
+        }
+
+        auto here = position(cell, width);
+        auto exits = maze.exits(here.row_, here.col_);
+        for (auto d = 0; d < 4; d++) {
+            auto direction = static_cast<GO>(d);
+            if (!(exits & bit(direction))) {
+                continue;
+            }
+
+            auto next = cell + offset(direction, width);
+            if (distance + 1 < get(next)) {
+                set(next, distance + 1);
+                queue_.emplace_back(distance + 1, next);
+            }
+        }
+    }
+
+    return count;
+}
+
+// Starts again from scratch with the same sources.
+std::size_t Distances::rebuild(const Maze& maze, Frontier& frontier) {
+    std::vector<Position> sources;
+
+    for (auto cell : sources_) {
+        sources.push_back(position(cell, width_));
+    }
+
+    return build(maze, sources, frontier);
+}
+
+std::uint32_t Distances::at(int row, int col) const {
+    return get(static_cast<std::size_t>(row) * width_ + col);
+}
+
+// Which way to go from here to get one step closer to the nearest source.
+// Returns false if here is a source or can't reach one.
+bool Distances::next(const Maze& maze, const Position& here,
+GO& direction) const {
+    auto cell = static_cast<std::size_t>(here.row_) * width_ + here.col_;
+    auto distance = get(cell);
+
+    if (distance == 0 || distance == UNREACHABLE) {
+        return false;
+    }
+
+    auto exits = maze.exits(here.row_, here.col_);
+    for (auto d = 0; d < 4; d++) {
+        direction = static_cast<GO>(d);
+        if ((exits & bit(direction)) &&
+        get(cell + offset(direction, width_)) == distance - 1) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::size_t Distances::bytes() const {
+    return near_.size() * sizeof(std::uint16_t) +
+        far_.size() * sizeof(std::uint32_t);
+}
+
+std::uint32_t Distances::get(std::size_t cell) const {
+    if (!near_.empty()) {
+        return (near_[cell] == FAR) ? UNREACHABLE : near_[cell];
+    }
+
+    return far_[cell];
+}
+
+void Distances::set(std::size_t cell, std::uint32_t distance) {
+    if (!near_.empty()) {
+        near_[cell] = distance;
+    } else {
+        far_[cell] = distance;
+    }
+}
+
+Wavefront::Wavefront() : reached_(0, 0), current_(0, 0), next_(0, 0),
+active_(), waiting_(), levels_{0} {
+}
+
+// The number of steps from from to to or Distances::UNREACHABLE if there is
+// no way between them.
+std::uint32_t Wavefront::distance(const Maze& maze, const Position& from,
+const Position& to) {
+    spread(maze, from, &to);
+
+    return reached_.at(to.row_, to.col_) ? levels_ : Distances::UNREACHABLE;
+}
+
+// Finds every cell which can be reached from from.  Returns how many there
+// are.
+std::size_t Wavefront::flood(const Maze& maze, const Position& from) {
+    return spread(maze, from, nullptr);
+}
+
+// How many levels (steps from the start) the last search went through.
+std::size_t Wavefront::levels() const {
+    return levels_;
+}
+
+// The cells found by the last search.
+const Maze& Wavefront::reached() const {
+    return reached_;
+}
+
+// The search itself.  current_ holds the frontier and active_ the numbers of
+// the words it is in.  Each level, each of those words is shifted east and
+// west (carrying into the words on either side) and copied north and south
+// into next_, noting the words in waiting_.  Then the bits in next_ which are
+// open and haven't been reached before become the new frontier.  Stops early
+// when to (if there is one) has been reached.
+std::size_t Wavefront::spread(const Maze& maze, const Position& from,
+const Position* to) {
+    fit(reached_, maze);
+    fit(current_, maze);
+    fit(next_, maze);
+    active_.clear();
+    levels_ = 0;
+
+    const auto* open = maze.row(0);
+    auto* reached = reached_.row(0);
+    auto* current = current_.row(0);
+    std::size_t stride = maze.stride();
+    auto words = maze.bytes() / sizeof(Maze::Word);
+    std::size_t count = 1;
+
+    reached_.set(from.row_, from.col_);
+    current_.set(from.row_, from.col_);
+    active_.push_back(from.row_ * stride + from.col_ / Maze::BITS);
+
+    while (!active_.empty()) {
+        if (to && reached_.at(to->row_, to->col_)) {
+            break;
+        }
+
+        waiting_.clear();
+        for (auto word : active_) {
+            auto bits = current[word];
+            auto col = word % stride;
+            current[word] = 0;
+
+            add(word, (bits << 1) | (bits >> 1));
+            if (col + 1 < stride) {
+                add(word + 1, bits >> (Maze::BITS - 1));
+            }
+            if (col > 0) {
+                add(word - 1, bits << (Maze::BITS - 1));
+            }
+            if (word >= stride) {
+                add(word - stride, bits);
+            }
+            if (word + stride < words) {
+                add(word + stride, bits);
+            }
+        }
+
+        active_.clear();
+        auto* next = next_.row(0);
+        for (auto word : waiting_) {
+            auto bits = next[word] & open[word] & ~reached[word];
+            next[word] = 0;
+
+            if (bits) {
+                reached[word] |= bits;
+                current[word] = bits;
+                count += __builtin_popcountll(bits);
+                active_.push_back(word);
+            }
+        }
+
+        if (!active_.empty()) {
+            levels_++;
+        }
+    }
+
+    return count;
+}
+
+void Wavefront::add(std::size_t word, Maze::Word bits) {
+    auto* next = next_.row(0);
+
+    if (bits) {
+        if (!next[word]) {
+            waiting_.push_back(word);
+        }
+        next[word] |= bits;
+    }
+}
+
+bool Distances::source(std::size_t cell) const {
+    return std::find(sources_.begin(), sources_.end(), cell) != sources_.end();
+}
+
+// One more than the distance of the closest open neighbour of cell or
+// UNREACHABLE if none of them have a distance.
+std::uint32_t Distances::nearest(const Maze& maze, std::size_t cell) const {
+    auto here = position(cell, width_);
+    auto exits = maze.exits(here.row_, here.col_);
+    auto result = UNREACHABLE;
+
+    for (auto d = 0; d < 4; d++) {
+        auto direction = static_cast<GO>(d);
+        if (exits & bit(direction)) {
+            auto distance = get(cell + offset(direction, width_));
+            if (distance != UNREACHABLE) {
+                result = std::min(result, distance + 1);
+            }
+        }
+    }
+
+    return result;
+}
+
+Workspace::Workspace() : frontier_(), seen_(0, 0), parent_(), back_(),
+seenBack_(0, 0), parentBack_(), now_(), later_(), open_(),
+deadEnds_(),
+distances_(), junctions_(), edges_() {
+}
+
+// Gets ready to solve maze.  The arrays for searching back from the end are
+// only set up if backwards is true.  Nothing is reallocated unless the size
+// of the maze has changed.
+void Workspace::reset(const Maze& maze, bool backwards) {
+    auto cells = static_cast<std::size_t>(maze.height()) * maze.width();
+
+    fit(seen_, maze);
+    frontier_.clear();
+    parent_.reset(cells);
+    now_.clear();
+    later_.clear();
+    open_.clear();
+
+    if (backwards) {
+        fit(seenBack_, maze);
+        back_.clear();
+        parentBack_.reset(cells);
+    }
+}
+
+
+const char* name(SOLVER solver) {
+    return solvers[static_cast<int>(solver)].name_;
+}
+
+bool find(const std::string& name, SOLVER& solver) {
+    for (const auto& s : solvers) {
+        if (name == s.name_) {
+            solver = s.solver_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Finds a path through maze from from to to.  Returns false if there isn't
+// one or solver is the wall follower which is not handled here.
+bool solve(SOLVER solver, const Maze& maze, const Position& from,
+const Position& to, Workspace& workspace, Solution& solution) {
+    const auto& s = solvers[static_cast<int>(solver)];
+
+    return s.solve_ && s.solve_(maze, from, to, workspace, solution);
+}
+
+// Dead-end filling.  Walls up every open cell apart from from and to which
+// has fewer than two open neighbours, then every cell that leaves with fewer
+// than two and so on.  In a perfect maze, only the path from from to to is
+// left afterwards.  Any of the solvers can be used on the result (and will
+// not have to look at as many cells) or it can be used just to show the
+// path.  Returns the number of cells filled.
+std::size_t fillDeadEnds(Maze& maze, const Position& from, const Position& to,
+Workspace& workspace) {
+    std::size_t width = maze.width();
+    auto& deadEnds = workspace.deadEnds_;
+    std::size_t filled = 0;
+
+    // The first dead ends are found a word at a time.  A cell is not a dead
+    // end if at least two of its neighbours are open.
+    deadEnds.clear();
+    for (auto row = 0; row < maze.height(); row++) {
+        for (auto word = 0; word < maze.stride(); word++) {
+            auto east = maze.open(row, word, GO::EAST);
+            auto south = maze.open(row, word, GO::SOUTH);
+            auto west = maze.open(row, word, GO::WEST);
+            auto north = maze.open(row, word, GO::NORTH);
+            auto many = (east & south) | (west & north) |
+                ((east | south) & (west | north));
+            auto dead = maze.row(row)[word] & ~many;
+
+            while (dead) {
+                deadEnds.push_back(row * width + word * Maze::BITS +
+                    __builtin_ctzll(dead));
+                dead &= dead - 1;
+            }
+        }
+    }
+
+    // Filling a dead end may make the cell it led to into one too.
+    while (!deadEnds.empty()) {
+        auto cell = deadEnds.back();
+        auto here = position(cell, width);
+        deadEnds.pop_back();
+
+        if (!maze.at(here.row_, here.col_) ||
+        (here.row_ == from.row_ && here.col_ == from.col_) ||
+        (here.row_ == to.row_ && here.col_ == to.col_)) {
+            continue;
+        }
+
+        auto exits = maze.exits(here.row_, here.col_);
+        if (exits & (exits - 1)) {
+            continue;
+        }
+
+        maze.set(here.row_, here.col_, false);
+        filled++;
+        if (exits) {
+            deadEnds.push_back(cell +
+                offset(static_cast<GO>(__builtin_ctz(exits)), width));
+        }
+    }
+
+    return filled;
+}
+
+// Breadth-first search.  Cells are visited in order of their distance from
+// from so the first path found to to is the shortest.  Each cell only needs
+// to remember which direction it was reached from (in 2 bits) to rebuild the
+// path afterwards.
+bool bfs(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    std::size_t width = maze.width();
+    auto& frontier = workspace.frontier_;
+    auto& seen = workspace.seen_;
+    auto& parent = workspace.parent_;
+    auto start = from.row_ * width + from.col_;
+    auto target = to.row_ * width + to.col_;
+
+    workspace.reset(maze);
+    solution.path_.clear();
+    solution.expanded_ = 0;
+
+    frontier.push(start);
+    seen.set(from.row_, from.col_);
+
+    while (!frontier.empty()) {
+        auto cell = frontier.pop();
+        auto here = position(cell, width);
+        auto exits = maze.exits(here.row_, here.col_);
+        solution.expanded_++;
+
+        if (cell == target) {
+            trace(width, cell, start, parent, solution.path_);
+            std::reverse(solution.path_.begin(), solution.path_.end());
+            return true;
+        }
+
+        for (auto d = 0; d < 4; d++) {
+            auto direction = static_cast<GO>(d);
+            if (!(exits & bit(direction))) {
+                continue;
+            }
+
+            auto next = cell + offset(direction, width);
+            auto there = position(next, width);
+            if (!seen.at(there.row_, there.col_)) {
+                seen.set(there.row_, there.col_);
+                parent.set(next, direction);
+                frontier.push(next);
+            }
+        }
+    }
+
+    return false;
+}
+
+// The number of steps from cell to to if there were no walls.
+std::uint32_t manhattan(const Position& cell, const Position& to) {
+    return std::abs(cell.row_ - to.row_) + std::abs(cell.col_ - to.col_);
+}
+
+// No guess at all, which makes astar() the same as Dijkstra's algorithm.
+std::uint32_t zero(const Position&, const Position&) {
+    return 0;
+}
+
+// A* search using the Manhattan distance to to as the estimate of how far
+// there is still to go.
+bool astar(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    return astar(maze, from, to, workspace, solution, MANHATTAN);
+}
+
+// Dijkstra's algorithm is A* search with no estimate at all.  As ZERO doesn't
+// change with every step this uses the binary heap.
+bool dijkstra(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    return astar(maze, from, to, workspace, solution, ZERO);
+}
+
+// A* search using heuristic as the estimate of how far there is still to go.
+// If every step changes the estimate by exactly 1, the estimated length of a
+// path through a cell (f) is either the same as that of the cell it was
+// reached from or 2 more.  That means the priority queue only needs two
+// buckets: now_ for cells with the smallest f and later_ for those with
+// f + 2.  Each entry is a cell number times 4 plus the direction it was
+// entered from.  A cell can be queued more than once but only the first time
+// it comes out counts.  Other heuristics need a real priority queue.
+bool astar(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution, const Heuristic& heuristic) {
+    if (!heuristic.unit_) {
+        return astarHeap(maze, from, to, workspace, solution, heuristic);
+    }
+
+    std::size_t width = maze.width();
+    auto& seen = workspace.seen_;
+    auto& parent = workspace.parent_;
+    auto& now = workspace.now_;
+    auto& later = workspace.later_;
+    auto start = from.row_ * width + from.col_;
+    auto target = to.row_ * width + to.col_;
+
+    workspace.reset(maze);
+    solution.path_.clear();
+    solution.expanded_ = 0;
+
+    now.push_back(start * 4);
+
+    while (!now.empty() || !later.empty()) {
+        if (now.empty()) {
+            now.swap(later);
+        }
+
+        auto entry = now.back();
+        now.pop_back();
+
+        auto cell = entry / 4;
+        auto here = position(cell, width);
+        if (seen.at(here.row_, here.col_)) {
+            continue;
+        }
+        seen.set(here.row_, here.col_);
+        if (cell != start) {
+            parent.set(cell, static_cast<GO>(entry % 4));
+        }
+        solution.expanded_++;
+
+        if (cell == target) {
+            trace(width, cell, start, parent, solution.path_);
+            std::reverse(solution.path_.begin(), solution.path_.end());
+            return true;
+        }
+
+        auto exits = maze.exits(here.row_, here.col_);
+        auto estimate = heuristic.estimate_(here, to);
+
+        for (auto d = 0; d < 4; d++) {
+            auto direction = static_cast<GO>(d);
+            if (!(exits & bit(direction))) {
+                continue;
+            }
+
+            auto next = cell + offset(direction, width);
+            auto there = position(next, width);
+            if (seen.at(there.row_, there.col_)) {
+                continue;
+            }
+
+            auto& bucket = (heuristic.estimate_(there, to) < estimate) ?
+                now : later;
+            bucket.push_back(next * 4 + d);
+        }
+    }
+
+    return false;
+}
+
+// Breadth-first searches from both ends at once, a level at a time from
+// whichever end has fewer cells waiting.  They stop as soon as one reaches a
+// cell the other has seen.  As neither search has found the other before
+// this level, no path can be shorter than the one through that cell.
+bool bidirectional(const Maze& maze, const Position& from,
+const Position& to, Workspace& workspace, Solution& solution) {
+    std::size_t width = maze.width();
+    auto start = from.row_ * width + from.col_;
+    auto target = to.row_ * width + to.col_;
+
+    workspace.reset(maze, true);
+    solution.path_.clear();
+    solution.expanded_ = 0;
+
+    if (start == target) {
+        solution.path_.push_back(from);
+        return true;
+    }
+
+    workspace.frontier_.push(start);
+    workspace.seen_.set(from.row_, from.col_);
+    workspace.back_.push(target);
+    workspace.seenBack_.set(to.row_, to.col_);
+
+    std::size_t meet;
+    bool met = false;
+    while (!met && !workspace.frontier_.empty() &&
+    !workspace.back_.empty()) {
+        if (workspace.frontier_.size() <= workspace.back_.size()) {
+            met = expand(maze, workspace.frontier_, workspace.seen_,
+                workspace.parent_, workspace.seenBack_, solution.expanded_,
+                meet);
+        } else {
+            met = expand(maze, workspace.back_, workspace.seenBack_,
+                workspace.parentBack_, workspace.seen_, solution.expanded_,
+                meet);
+        }
+    }
+
+    if (!met) {
+        return false;
+    }
+
+    // Both searches have a parent for the meeting cell (unless it is where
+    // one of them started) so the path is from from to there and then on
+    // to to.
+    auto& path = solution.path_;
+    trace(width, meet, start, workspace.parent_, path);
+    std::reverse(path.begin(), path.end());
+    path.pop_back();
+    trace(width, meet, target, workspace.parentBack_, path);
+
+    return true;
+}
+
+// Builds the distances of every cell from to and then goes downhill from
+// from.  This is slower than the other solvers for one path but afterwards
+// the way to to from anywhere else in the maze is known straight away (see
+// Distances::next().)
+bool descend(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    std::size_t width = maze.width();
+    auto& distances = workspace.distances_;
+    auto cell = from.row_ * width + from.col_;
+    auto here = from;
+    GO direction;
+
+    solution.path_.clear();
+    solution.expanded_ = distances.build(maze, { to }, workspace.frontier_);
+
+    if (distances.at(from.row_, from.col_) == Distances::UNREACHABLE) {
+        return false;
+    }
+
+    solution.path_.push_back(here);
+    while (distances.next(maze, here, direction)) {
+        cell += offset(direction, width);
+        here = position(cell, width);
+        solution.path_.push_back(here);
+    }
+
+    return true;
+}
+
+// Builds the graph of junctions and then uses Dijkstra's algorithm to find
+// the shortest path through it.  expanded_ is the number of junctions whose
+// distance from from was worked out.
+bool junctions(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    auto& graph = workspace.junctions_;
+
+    graph.build(maze, from, to);
+    auto start = graph.node(from);
+    auto length = graph.dijkstra(start, graph.node(to), workspace.edges_,
+        solution.expanded_);
+
+    if (length == Junctions::NONE) {
+        solution.path_.clear();
+        return false;
+    }
+
+    graph.expand(maze, start, workspace.edges_, solution.path_);
+    return true;
+}
+
+// Builds the graph of junctions and then explores it with Tremaux's
+// algorithm.  The path is not always the shortest one unless the maze is
+// perfect.  expanded_ is the total length of the corridors walked.
+bool tremaux(const Maze& maze, const Position& from, const Position& to,
+Workspace& workspace, Solution& solution) {
+    auto& graph = workspace.junctions_;
+
+    graph.build(maze, from, to);
+    auto start = graph.node(from);
+    auto length = graph.tremaux(start, graph.node(to), workspace.edges_,
+        solution.expanded_);
+
+    if (length == Junctions::NONE) {
+        solution.path_.clear();
+        return false;
+    }
+
+    graph.expand(maze, start, workspace.edges_, solution.path_);
+    return true;
+}
@@ -4,253 +4,60 @@
 // Copyright (C) 2020, Consolidated Braincells Inc.
 // "Do what thou wilt" shall be the whole of the license.
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
-#include <random>
+#include <fstream>
+#include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
 #include <unistd.h>
+#include "batch.h"
+#include "bench.h"
+#include "mazefile.h"
+#include "model.h"
+#include "pbm.h"
+#include "solve.h"
 
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 
-constexpr int MAP_HEIGHT = 17;
-constexpr int MAP_WIDTH = 17;
 constexpr int CELL_HEIGHT = 4;
 constexpr int CELL_WIDTH = 4;
 constexpr int SCALE = 8;
+constexpr int SCREEN_SIZE = 544;
+constexpr int VIEW_SIZE = 127;
+constexpr int DEFAULT_SIZE = 17;
 constexpr float TICK = 1.0f / 60.0f;
 
-using Maze = std::array<std::array<bool, MAP_WIDTH>, MAP_HEIGHT>;
-
-enum class GO { EAST, SOUTH, WEST, NORTH };
-
-struct Position {
-    int row_;
-    int col_;
-};
-
-class Model {
-public:
-    explicit Model(unsigned);
-
-    void update();
-
-    unsigned seed_;
-    std::mt19937 rnd_;
-    Maze maze_;
-    Position entrance_;
-    Position exit_;
-    Position player_;
-    float tick_;
-    GO direction_;
-
-private:
-
-    Maze makeMaze();
-    Position makeEntrance();
-    Position makeExit();
-    void tryNorth();
-    void tryEast();
-    void tryWest();
-    void trySouth();
-};
-
-Model::Model(unsigned seed) : seed_{seed}, rnd_{seed_}, maze_{makeMaze()},
-entrance_{makeEntrance()}, exit_{makeExit()}, player_{entrance_}, tick_{0},
-direction_{GO::SOUTH} {
-    maze_[entrance_.row_][entrance_.col_] = true;
-    maze_[exit_.row_][exit_.col_] = true;
-}
-
-void Model::update() {
-    if (player_.row_ == exit_.row_ && player_.col_ == exit_.col_) {
-        return;
-    }
-
-    switch (direction_) {
-        case GO::NORTH:
-            player_.row_--;
-            tryNorth();
-            break;
-         case GO::EAST:
-            player_.col_++;
-            tryEast();
-            break;
-        case GO::SOUTH:
-            player_.row_++;
-            trySouth();
-            break;
-        case GO::WEST:
-            player_.col_--;
-            tryWest();
-            break;
-   }
-}
-
-Maze Model::makeMaze() {
-    Maze maze;
-
-    for (auto & row : maze) {
-        for (auto & col : row) {
-            col = false;
-        }
-    }
-
-    std::array<Position, 4> dirs {
-        Position{-1, 0}, // North
-        Position{1,  0}, // South
-        Position{0, -1}, // West
-        Position{0,  1}  // East
-    };
-
-    int done = 0;
-
-    std::uniform_int_distribution<int> height(1, (MAP_HEIGHT / 2));
-    std::uniform_int_distribution<int> width(1,  (MAP_WIDTH / 2));
-    std::uniform_int_distribution<int> direction(0, 4);
-
-    do {
-        // this code is used to make sure rows and columns are odd
-
-        int row = 1 + (height(rnd_) - 1) * 2;
-        int col = 1 + (width(rnd_) - 1) * 2;
-
-        if (done == 0) {
-            maze[row][col] = true;
-        }
-
-        if(maze[row][col]) {
-
-            //Randomize Directions
-            std::shuffle(dirs.begin(), dirs.end(), rnd_);
-
-            bool blocked = true;
-
-            do {
-                if (direction(rnd_) == 0) {
-                    std::shuffle(dirs.begin(), dirs.end(), rnd_);
-                }
-                blocked = true;
-                for (auto i = 0; i < 4; i++) {
-                    // Determine which direction the tile is
-                    auto r = row + dirs[i].row_ * 2;
-                    auto c = col + dirs[i].col_ * 2;
-                    //Check to see if the tile can be used
-                    if (r >= 1 && r < MAP_HEIGHT - 1 && c >= 1 &&
-                    c < MAP_WIDTH - 1) {
-                        if (!maze[r][c]) {
-                            //create destination location
-                            maze[r][c] = true;
-                            //create intermediate location
-                            maze[row + dirs[i].row_][col + dirs[i].col_] = true;
-                            row = r;
-                            col = c;
-                            blocked = false;
-                            done++;
-                            break;
-                        }
-                    }
-                }
-                //recursive, no directions found, loop back a node
-            } while (!blocked);
-        }
-
-    } while (done + 1 < ((MAP_HEIGHT - 1) * (MAP_WIDTH - 1)) / 4);
-
-    return maze;
-}
-
-// Set the entrance on the top row.  it has to be above an empty cell on the
-// next row.  The freeCols vector contains the list of empty cells.
-Position Model::makeEntrance() {
-    std::vector<int> freeCols;
-
-    for (auto i = 1; i < MAP_WIDTH - 1; i++) {
-        if (maze_[1][i]) {
-            freeCols.push_back(i);
-        }
-    }
-
-    std::uniform_int_distribution<int> col(0,freeCols.size() - 1);
-
-    return {0, freeCols[col(rnd_)] };
-}
-
-// Set the exit on the bottom row.  it has to be below an empty cell on the
-// previous row.  Once again, freeCols contains the list of empty cells. 
-Position Model::makeExit() {
-    std::vector<int> freeCols;
-
-    for (auto i = 1; i < MAP_WIDTH - 1; i++) {
-        if (maze_[MAP_HEIGHT - 2][i]) {
-            freeCols.push_back(i);
-        }
-    }
-
-    std::uniform_int_distribution<int> col(0,freeCols.size() - 1);
-
-    return {MAP_HEIGHT - 1, freeCols[col(rnd_)] };
-}
-
-void Model::tryNorth() {
-    if (maze_[player_.row_][player_.col_ + 1]) {
-        direction_ = GO::EAST;
-    } else if(maze_[player_.row_ - 1][player_.col_]) {
-        direction_ = GO::NORTH;
-    } else if (maze_[player_.row_][player_.col_ - 1]) {
-        direction_ = GO::WEST;
-    } else if(maze_[player_.row_ + 1][player_.col_]) {
-        direction_ = GO::SOUTH;
-    }
-}
-
-void Model::tryEast() {
-    if (maze_[player_.row_ + 1][player_.col_]) {
-        direction_ = GO::SOUTH;
-    } else if(maze_[player_.row_][player_.col_ + 1]) {
-        direction_ = GO::EAST;
-    } else if(maze_[player_.row_ - 1][player_.col_]) {
-        direction_ = GO::NORTH;
-    } else if(maze_[player_.row_][player_.col_ - 1]) {
-        direction_ = GO::WEST;
-    }
-}
-
-void Model::trySouth() {
-    if (maze_[player_.row_][player_.col_ - 1]) {
-        direction_ = GO::WEST;
-    } else if (maze_[player_.row_ + 1][player_.col_]) {
-        direction_ = GO::SOUTH;
-    } else if (maze_[player_.row_][player_.col_ + 1]) {
-        direction_ = GO::EAST;
-    } else if (maze_[player_.row_ - 1][player_.col_]) {
-        direction_ = GO::NORTH;
-    }
-}
-
-void Model::tryWest() {
-    if (maze_[player_.row_ - 1][player_.col_]) {
-        direction_ = GO::NORTH;
-        player_.row_--;
-    } else if (maze_[player_.row_][player_.col_ - 1]) {
-        direction_ = GO::WEST;
-    } else if (maze_[player_.row_ + 1][player_.col_]) {
-        direction_ = GO::SOUTH;
-    } else if (maze_[player_.row_][player_.col_ + 1]) {
-        direction_ = GO::EAST;
-    }
-}
-
 class View : public olc::PixelGameEngine {
 public:
     explicit View(Model&);
 
+    bool construct();
     void draw();
     bool OnUserCreate() override;
     bool OnUserUpdate(float) override;
 
 private:
+    void drawMaze();
+    void erase(const Position&);
+    void drawAgents();
+    bool scroll();
+
     Model& model_;
+    int viewHeight_;
+    int viewWidth_;
+    Position origin_;
+    std::uint8_t mazeLayer_;
+    bool redraw_;
+    std::vector<Position> drawn_;
+    int dirtyTop_;
+    int dirtyBottom_;
     std::unique_ptr<olc::Sprite> wall_;
     std::unique_ptr<olc::Sprite> floor_;
     std::unique_ptr<olc::Sprite> playerEast_;
@@ -260,6 +67,9 @@ private:
 };
 
 View::View(Model& model) : model_{model},
+viewHeight_{std::min(model_.maze_.height(), VIEW_SIZE)},
+viewWidth_{std::min(model_.maze_.width(), VIEW_SIZE)}, origin_{0, 0},
+mazeLayer_{0}, redraw_{true}, drawn_{}, dirtyTop_{0}, dirtyBottom_{0},
 wall_{std::make_unique<olc::Sprite>(CELL_WIDTH, CELL_HEIGHT)},
 floor_{std::make_unique<olc::Sprite>(CELL_WIDTH, CELL_HEIGHT)},
 playerEast_{std::make_unique<olc::Sprite>(CELL_WIDTH, CELL_HEIGHT)},
@@ -271,6 +81,16 @@ playerWest_{std::make_unique<olc::Sprite>(CELL_WIDTH, CELL_HEIGHT)} {
     sAppName = title.str();
 }
 
+// Only up to VIEW_SIZE cells in each direction are shown at once.  Smaller
+// mazes are scaled up to fill roughly SCREEN_SIZE pixels.
+bool View::construct() {
+    auto scale = std::clamp(SCREEN_SIZE /
+        std::max(viewWidth_ * CELL_WIDTH, viewHeight_ * CELL_HEIGHT), 1, SCALE);
+
+    return Construct(viewWidth_ * CELL_WIDTH, viewHeight_ * CELL_HEIGHT, scale,
+        scale);
+}
+
 bool View::OnUserCreate() {
     for (auto row = 0; row < CELL_HEIGHT; ++row) {
         for (auto col = 0; col < CELL_WIDTH; ++col) {
@@ -304,6 +124,8 @@ bool View::OnUserCreate() {
         }
     }
 
+    mazeLayer_ = static_cast<std::uint8_t>(CreateLayer());
+    EnableLayer(mazeLayer_, true);
     draw();
 
     return true;
@@ -315,25 +137,39 @@ bool View::OnUserUpdate(float elapsedTime) {
     if (model_.tick_ >= TICK) {
         model_.tick_ = 0;
         model_.update();
+        model_.agents_.step(model_.maze_, model_.rnd_);
         draw();
+    } else {
+        // Nothing has moved so there is nothing new to show.
+        UpdateLayerRows(0, 0, 0);
     }
 
     return true;
 }
 
+// The maze is drawn into a layer of its own which only changes when the view
+// scrolls.  The player and agents are drawn on a transparent layer over it.
+// Only the cells they were in last time and the ones they are in now are
+// drawn and only the rows of the screen which were drawn in are uploaded.
 void View::draw() {
-    Clear(olc::BLACK);
-
-    for (size_t row = 0; row < MAP_HEIGHT; ++row) {
-       for (size_t col = 0; col < MAP_WIDTH; ++col) {
-           if (model_.maze_[row][col]) {
-               DrawSprite(col * CELL_WIDTH, row * CELL_HEIGHT, floor_.get());
-           } else {
-               DrawSprite(col * CELL_WIDTH, row * CELL_HEIGHT, wall_.get());
-           }
-       }
+    if (scroll() || redraw_) {
+        redraw_ = false;
+        drawMaze();
+        Clear(olc::BLANK);
+        drawn_.clear();
+        dirtyTop_ = 0;
+        dirtyBottom_ = viewHeight_;
+    } else {
+        dirtyTop_ = viewHeight_;
+        dirtyBottom_ = 0;
+        for (const auto& cell : drawn_) {
+            erase(cell);
+        }
+        drawn_.clear();
     }
 
+    drawAgents();
+
     olc::Sprite* player = nullptr;
     switch(model_.direction_) {
         case GO::EAST:
@@ -349,27 +185,441 @@ void View::draw() {
             player = playerWest_.get();
             break;
     }
-    DrawSprite(model_.player_.col_ * CELL_WIDTH,
-        model_.player_.row_ * CELL_HEIGHT, player);
+    auto row = model_.player_.row_ - origin_.row_;
+    DrawSprite((model_.player_.col_ - origin_.col_) * CELL_WIDTH,
+        row * CELL_HEIGHT, player);
+    drawn_.push_back(model_.player_);
+    dirtyTop_ = std::min(dirtyTop_, row);
+    dirtyBottom_ = std::max(dirtyBottom_, row + 1);
+
+    UpdateLayerRows(0, dirtyTop_ * CELL_HEIGHT, dirtyBottom_ * CELL_HEIGHT);
+}
+
+// Draws the part of the maze in view into its layer.
+void View::drawMaze() {
+    SetDrawTarget(mazeLayer_);
+
+    for (auto row = 0; row < viewHeight_; ++row) {
+       for (auto col = 0; col < viewWidth_; ++col) {
+           if (model_.maze_.at(origin_.row_ + row, origin_.col_ + col)) {
+               DrawSprite(col * CELL_WIDTH, row * CELL_HEIGHT, floor_.get());
+           } else {
+               DrawSprite(col * CELL_WIDTH, row * CELL_HEIGHT, wall_.get());
+           }
+       }
+    }
+
+    SetDrawTarget(nullptr);
+}
+
+// Lets the maze show through a cell of the top layer again.
+void View::erase(const Position& cell) {
+    auto row = cell.row_ - origin_.row_;
+    auto col = cell.col_ - origin_.col_;
+
+    FillRect(col * CELL_WIDTH, row * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT,
+        olc::BLANK);
+    dirtyTop_ = std::min(dirtyTop_, row);
+    dirtyBottom_ = std::max(dirtyBottom_, row + 1);
+}
+
+// All the agents in view are drawn in one go straight into the screen
+// buffer, a block of each policy's colour per agent.
+void View::drawAgents() {
+    static const olc::Pixel colours[POLICIES] = {
+        olc::BLUE, olc::DARK_GREEN, olc::RED
+    };
+    const auto& agents = model_.agents_;
+    auto* screen = GetDrawTarget()->GetData();
+    auto width = ScreenWidth();
+
+    for (auto p = 0; p < POLICIES; p++) {
+        auto policy = static_cast<POLICY>(p);
+
+        for (auto i = agents.first(policy); i < agents.last(policy); i++) {
+            auto row = agents.rows_[i] - origin_.row_;
+            auto col = agents.cols_[i] - origin_.col_;
+            if (row < 0 || row >= viewHeight_ || col < 0 || col >= viewWidth_) {
+                continue;
+            }
+
+            drawn_.push_back({agents.rows_[i], agents.cols_[i]});
+            dirtyTop_ = std::min(dirtyTop_, row);
+            dirtyBottom_ = std::max(dirtyBottom_, row + 1);
+
+            auto* block = screen + row * CELL_HEIGHT * width + col * CELL_WIDTH;
+            for (auto y = 0; y < CELL_HEIGHT; y++) {
+                std::fill(block + y * width, block + y * width + CELL_WIDTH,
+                    colours[p]);
+            }
+        }
+    }
+}
+
+// If the player has walked off the part of the maze being shown, recenter the
+// view on them.  Returns true if the view moved.
+bool View::scroll() {
+    const auto& player = model_.player_;
+    auto origin = origin_;
+
+    if (player.row_ < origin_.row_ ||
+    player.row_ >= origin_.row_ + viewHeight_) {
+        origin_.row_ = std::clamp(player.row_ - viewHeight_ / 2, 0,
+            model_.maze_.height() - viewHeight_);
+    }
+
+    if (player.col_ < origin_.col_ ||
+    player.col_ >= origin_.col_ + viewWidth_) {
+        origin_.col_ = std::clamp(player.col_ - viewWidth_ / 2, 0,
+            model_.maze_.width() - viewWidth_);
+    }
+
+    return origin.row_ != origin_.row_ || origin.col_ != origin_.col_;
 }
 
 void usage(const char* progname, int status) {
     std::cerr <<
-        "Usage: " << progname << " [-s seed]|[-h|-?]\n"
+        "Usage: " << progname << " [-s seed] [-r rows] [-c cols] [-a algorithm]\n"
+        << "    [-t threads] [-l file [-i index]] [-S solver] [-d] [-w]\n"
+        << "    [-A agents [-P policy]] [-p file] [-o file] [-n count]\n"
+        << "    [-b benchmark]|[-h|-?]\n"
         << "    -s Seed for random number generator\n"
+        << "    -r Height of the maze (odd, default " << DEFAULT_SIZE << ")\n"
+        << "    -c Width of the maze (odd, default " << DEFAULT_SIZE << ")\n"
+        << "    -a Maze generation algorithm: carver (default), backtracker,\n"
+        << "       eller, kruskal, wilson or tiled\n"
+        << "    -t Number of threads for the tiled algorithm (default one per\n"
+        << "       processor)\n"
+        << "    -S Maze solving algorithm: follower (default), bfs, astar,\n"
+        << "       bidirectional, distance, junctions, tremaux or dijkstra\n"
+        << "    -d Fill in the dead ends of the maze before solving it\n"
+        << "    -w Walk to the exit as fast as possible instead of displaying\n"
+        << "       the maze\n"
+        << "    -A Number of extra agents walking to the exit\n"
+        << "    -P How the agents find their way: follower (default), distance,\n"
+        << "       random or mixed (an equal number of each)\n"
+        << "    -p Write the maze to file (- for standard output) as a PBM image\n"
+        << "       instead of displaying it\n"
+        << "    -l Load a maze from file instead of generating one\n"
+        << "    -i Which maze in the file given by -l to load (default 0)\n"
+        << "    -o Save the maze to file instead of displaying it\n"
+        << "    -n Generate count mazes with seeds starting from the one given\n"
+        << "       by -s without displaying them (-o saves them all)\n"
+        << "    -b Run a benchmark (" << benchmarks() << ")\n"
+        << "       on mazes of the given size instead of displaying a maze\n"
         << "    -h,-? Display this help message\n";
     exit(status);
 }
 
+// Maze dimensions must be odd so that there is a wall all the way around.
+int size(const char* progname, const char* arg) {
+    auto value = std::stoi(arg);
+
+    if (value < 3 || value % 2 == 0) {
+        std::cerr << "Maze dimensions must be odd and at least 3.\n";
+        usage(progname, EXIT_FAILURE);
+    }
+
+    return value;
+}
+
+void report(GENERATOR generator, int rows, int cols,
+const std::chrono::steady_clock::time_point& start, std::size_t bytes) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::clog << rows << 'x' << cols << " maze generated by " << name(generator)
+        << " in " << elapsed.count() << "s ("
+        << static_cast<double>(rows) * cols / elapsed.count() << " cells/s)";
+    if (bytes) {
+        std::clog << " using " << bytes << " bytes";
+    }
+    std::clog << std::endl;
+}
+
+// Eller's algorithm can write a maze as it is generated so it never has to be
+// in memory all at once.  Model chooses the entrance and exit after the maze
+// is made but here the entrance is needed before anything else so the maze is
+// generated twice.  The first time only the second and next to last rows are
+// kept, in ends, which is all chooseEntrance() and chooseExit() look at.  The
+// second time the maze is written out.  This way the maze is the same as the
+// one -o would save for the same seed.
+void stream(unsigned seed, int rows, int cols, std::ostream& out) {
+    Maze ends(4, cols);
+    std::mt19937 rnd{seed};
+
+    eller(rows, cols, rnd, [&](int row, const Maze::Word* words) {
+        if (row == 1) {
+            std::copy(words, words + ends.stride(), ends.row(1));
+        }
+        if (row == rows - 2) {
+            std::copy(words, words + ends.stride(), ends.row(2));
+        }
+    });
+    auto entrance = chooseEntrance(ends, rnd).col_;
+    auto exit = chooseExit(ends, rnd).col_;
+
+    std::vector<Maze::Word> edge(ends.stride());
+    PBM pbm(out, rows, cols);
+
+    rnd.seed(seed);
+    eller(rows, cols, rnd, [&](int row, const Maze::Word* words) {
+        if (row == 0 || row == rows - 1) {
+            auto col = (row == 0) ? entrance : exit;
+            std::fill(edge.begin(), edge.end(), 0);
+            edge[col / Maze::BITS] |= Maze::Word{1} << (col % Maze::BITS);
+            pbm.row(edge.data());
+        } else {
+            pbm.row(words);
+        }
+    });
+}
+
+// Batch mode.  Generate count mazes and report how fast that was.
+int generateMany(unsigned seed, unsigned long count, int rows, int cols,
+GENERATOR generator, unsigned threads, const std::string& output) {
+    int fd = -1;
+
+    if (!output.empty()) {
+        fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) {
+            std::cerr << "Cannot write " << output << ".\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto ok = batch(seed, count, rows, cols, generator, threads, fd);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    if (fd != -1 && close(fd) == -1) {
+        ok = false;
+    }
+    if (!ok) {
+        std::cerr << "Cannot write " << output << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::clog << count << ' ' << rows << 'x' << cols << " mazes (seeds " << seed
+        << " to " << seed + count - 1 << ") generated by " << name(generator)
+        << " in " << elapsed.count() << "s (" << count / elapsed.count()
+        << " mazes/s)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+Model load(const MazeFile& mazeFile) {
+    const auto& header = mazeFile.header();
+
+    return Model(header.seed_, static_cast<GENERATOR>(header.generator_),
+        mazeFile.maze(), { header.entranceRow_, header.entranceCol_ },
+        { header.exitRow_, header.exitCol_ });
+}
+
+double since(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        start).count();
+}
+
+// Solves the maze with solver and compares the length of the path found with
+// the number of steps the wall follower takes.  If fill is true, the dead ends
+// are filled in first and the time taken to solve the maze is compared with
+// the time it takes without doing that.
+int solveOne(Model& model, SOLVER solver, bool fill) {
+    Workspace workspace;
+    Model original = model;
+
+    if (fill) {
+        auto start = std::chrono::steady_clock::now();
+        auto filled = model.fillDeadEnds(workspace);
+        auto elapsed = since(start);
+
+        std::size_t open = 0;
+        for (auto row = 0; row < model.maze_.height(); row++) {
+            open += model.maze_.count(row, 0, model.maze_.width());
+        }
+        std::clog << "filled " << filled << " dead end cells in " << elapsed
+            << "s leaving " << open << " open" << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto solved = model.solve(solver, workspace);
+    auto elapsed = since(start);
+
+    if (!solved) {
+        std::cerr << "No path found from the entrance to the exit.\n";
+        return EXIT_FAILURE;
+    }
+
+    if (solver != SOLVER::FOLLOWER) {
+        std::clog << name(solver) << " found a path of "
+            << model.solution_.path_.size() - 1 << " steps in " << elapsed
+            << "s (" << model.solution_.expanded_ << " cells expanded)";
+
+        if (fill) {
+            Solution unfilled{{}, 0};
+            start = std::chrono::steady_clock::now();
+            ::solve(solver, original.maze_, original.entrance_,
+                original.exit_, workspace, unfilled);
+            std::clog << "; " << since(start) << "s ("
+                << unfilled.expanded_ << " cells expanded) without filling";
+        }
+        std::clog << std::endl;
+    }
+
+    std::clog << name(SOLVER::FOLLOWER) << " takes " << original.run()
+        << " steps";
+    if (fill) {
+        Model follower = model;
+        follower.solve(SOLVER::FOLLOWER, workspace);
+        std::clog << " (" << follower.run() << " after filling)";
+    }
+    std::clog << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+// Moves the player all the way to the exit as fast as possible instead of one
+// step per TICK.
+int walk(Model& model) {
+    std::size_t revisits;
+
+    auto start = std::chrono::steady_clock::now();
+    auto steps = model.run(revisits);
+    auto elapsed = since(start);
+
+    if (!steps && !model.finished()) {
+        std::cerr << "The exit could not be reached.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::clog << name(model.solver_) << " reached the exit in " << steps
+        << " steps (" << revisits << " revisits) in " << elapsed << "s ("
+        << steps / elapsed << " steps/s)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+// Moves all the agents until they have reached the exit (or for as long as
+// the wall follower could possibly need.)
+void swarm(Model& model) {
+    auto& agents = model.agents_;
+    std::size_t limit = 4 * static_cast<std::size_t>(model.maze_.height()) *
+        model.maze_.width();
+    std::size_t ticks = 0;
+    std::size_t steps = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (agents.arrived() < agents.size() && ticks < limit) {
+        steps += agents.step(model.maze_, model.rnd_);
+        ticks++;
+    }
+    auto elapsed = since(start);
+
+    std::clog << agents.arrived() << " of " << agents.size()
+        << " agents reached the exit in " << ticks << " ticks; " << steps
+        << " agent steps in " << elapsed << "s (" << steps / elapsed
+        << " agent steps/s)" << std::endl;
+}
+
+int saveOne(const Model& model, const std::string& output) {
+    auto fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    auto ok = fd != -1 && save(fd, 0, makeHeader(model.maze_, model.seed_,
+        model.generator_, model.entrance_, model.exit_), model.maze_);
+
+    if (fd != -1 && close(fd) == -1) {
+        ok = false;
+    }
+    if (!ok) {
+        std::cerr << "Cannot write " << output << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char* argv[]) {
     int opt;
     unsigned seed = 0;
-
-    while ((opt = getopt(argc, argv, "h?s:")) != -1) {
+    int rows = DEFAULT_SIZE;
+    int cols = DEFAULT_SIZE;
+    GENERATOR generator = GENERATOR::CARVER;
+    unsigned threads = 0;
+    std::string image;
+    std::string bench;
+    unsigned long count = 0;
+    std::string output;
+    std::string input;
+    unsigned long index = 0;
+    SOLVER solver = SOLVER::FOLLOWER;
+    bool fill = false;
+    bool walking = false;
+    std::size_t agents = 0;
+    std::string policy = name(POLICY::FOLLOWER);
+
+    while ((opt = getopt(argc, argv, "h?s:r:c:a:t:l:i:S:dwA:P:p:n:o:b:")) != -1) {
         switch (opt) {
             case 's':
                 seed = std::stoul(optarg);
                 break;
+            case 'r':
+                rows = size(argv[0], optarg);
+                break;
+            case 'c':
+                cols = size(argv[0], optarg);
+                break;
+            case 'a':
+                if (!find(optarg, generator)) {
+                    std::cerr << "Unknown algorithm " << optarg << ".\n";
+                    usage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 't':
+                threads = std::stoul(optarg);
+                break;
+            case 'l':
+                input = optarg;
+                break;
+            case 'i':
+                index = std::stoul(optarg);
+                break;
+            case 'S':
+                if (!find(optarg, solver)) {
+                    std::cerr << "Unknown solver " << optarg << ".\n";
+                    usage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'd':
+                fill = true;
+                break;
+            case 'w':
+                walking = true;
+                break;
+            case 'A':
+                agents = std::stoul(optarg);
+                break;
+            case 'P': {
+                POLICY p;
+                policy = optarg;
+                if (policy != "mixed" && !find(policy, p)) {
+                    std::cerr << "Unknown policy " << policy << ".\n";
+                    usage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            }
+            case 'p':
+                image = optarg;
+                break;
+            case 'n':
+                count = std::stoul(optarg);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 'b':
+                bench = optarg;
+                break;
             case 'h':
             case '?':
                 usage(argv[0], EXIT_SUCCESS);
@@ -384,11 +634,111 @@ int main(int argc, char* argv[]) {
         seed = std::random_device()();
     }
 
-    Model model(seed);
+    if (!bench.empty()) {
+        if (!benchmark(bench, seed, rows, cols, threads)) {
+            std::cerr << "Unknown benchmark " << bench << ".\n";
+            usage(argv[0], EXIT_FAILURE);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (count) {
+        return generateMany(seed, count, rows, cols, generator, threads, output);
+    }
+
+    // An eller maze written with -p is never all in memory at once so there
+    // is nothing to solve, walk through or save.
+    auto streaming = !image.empty() && input.empty() &&
+        generator == GENERATOR::ELLER;
+    if (streaming && (solver != SOLVER::FOLLOWER || fill || walking || agents ||
+    !output.empty())) {
+        std::cerr << "-S, -d, -w, -A and -o cannot be used when an eller maze "
+            "is written with -p.\n";
+        usage(argv[0], EXIT_FAILURE);
+    }
+
+    std::ofstream file;
+    if (!image.empty() && image != "-") {
+        file.open(image, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot write " << image << ".\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = (image == "-") ? std::cout : file;
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (streaming) {
+        stream(seed, rows, cols, out);
+        report(generator, rows, cols, start, 0);
+        return out ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // The maze in a file is used where it is, so the file has to stay open
+    // for as long as the model.
+    MazeFile mazeFile;
+    if (!input.empty() && !mazeFile.open(input, index)) {
+        std::cerr << "Cannot load maze " << index << " from " << input << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    Model model = input.empty() ? Model(seed, rows, cols, generator, threads) :
+        load(mazeFile);
+
+    if (input.empty()) {
+        report(generator, rows, cols, start, model.maze_.bytes());
+    } else {
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::clog << model.maze_.height() << 'x' << model.maze_.width()
+            << " maze (seed " << model.seed_ << ", " << name(model.generator_)
+            << ") loaded from " << input << " in " << elapsed.count() << 's'
+            << std::endl;
+    }
+
+    if ((solver != SOLVER::FOLLOWER || fill) &&
+    solveOne(model, solver, fill) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    if (agents) {
+        std::array<std::size_t, POLICIES> counts{};
+        POLICY p;
+        if (find(policy, p)) {
+            counts[static_cast<int>(p)] = agents;
+        } else {
+            for (auto i = 0u; i < POLICIES; i++) {
+                counts[i] = agents / POLICIES + (i < agents % POLICIES);
+            }
+        }
+        model.agents_ = Agents(model.maze_, model.exit_, counts, model.rnd_);
+    }
+
+    if (walking && walk(model) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    if (walking && agents) {
+        swarm(model);
+    }
+
+    if (!output.empty()) {
+        return saveOne(model, output);
+    }
+
+    if (!image.empty()) {
+        PBM(out, model.maze_.height(), model.maze_.width()).write(model.maze_);
+        return out ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (walking) {
+        return EXIT_SUCCESS;
+    }
+
     View view(model);
 
-    if (view.Construct(MAP_WIDTH * CELL_WIDTH, MAP_HEIGHT * CELL_HEIGHT, SCALE,
-    SCALE)) {
+    if (view.construct()) {
         view.Start();
     }
 